@@ -1,9 +1,11 @@
 #ifndef VIDEOCAPTURE_H
 #define VIDEOCAPTURE_H
 
+#include "VideoFrame.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/videodev2.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,26 +15,32 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-#define VIDEO_CAPTURE_BUFFER_COUNT 3
-
-typedef struct FrameBuffer {
-    void*         start;
-    unsigned long length;
-    unsigned long bytesUsed;
-    uint64_t      uTimestamp;
-} FrameBuffer;
+#define VIDEO_CAPTURE_AUTO_BUFFER_COUNT 0
+#define VIDEO_CAPTURE_DEFAULT_BUFFER_COUNT 3
+#define VIDEO_CAPTURE_MIN_BUFFER_COUNT 2
+#define VIDEO_CAPTURE_MAX_BUFFER_COUNT VIDEO_MAX_FRAME
+#define VIDEO_CAPTURE_AUTO_STALL_USECONDS 50000
+#define VIDEO_CAPTURE_MAX_QUALITY 100
 
 typedef struct VideoCapture {
-    int                 fd;
-    FrameBuffer*        frameBuffers;
-    FrameBuffer*        leasedFrameBuffer;
-    struct v4l2_buffer* leasedV4l2Buffer;
-    uint64_t            epochTimeShift;
+    int          fd;
+    VideoFrame*  frames;
+    unsigned int frameCount;
+    bool         latest;
+    uint64_t     epochTimeShift;
+    uint32_t     lastSequence;
+    bool         lastSequenceInitialized;
+    uint64_t     droppedFrameCount;
+    uint64_t     skippedFrameCount;
+    bool         qualityControl;
+    int          qualityMinimum;
+    int          qualityDefault;
+    unsigned int quality;
 } VideoCapture;
 
-VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth, unsigned int resolutionHeight, unsigned int timebaseNumerator, unsigned int timebaseDenominator);
-void          VideoCaptureGetFrame(VideoCapture* videoCapture);
-void          VideoCaptureReturnFrame(VideoCapture* videoCapture);
+VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth, unsigned int resolutionHeight, unsigned int timebaseNumerator, unsigned int timebaseDenominator, unsigned int bufferCount, bool latest);
+VideoFrame*   VideoCaptureGetFrame(VideoCapture* videoCapture);
+void          VideoCaptureSetQuality(VideoCapture* videoCapture, unsigned int quality);
 void          VideoCaptureFree(VideoCapture* videoCapture);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef VIDEOFRAME_H
+#define VIDEOFRAME_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+typedef struct VideoFrame VideoFrame;
+
+typedef void (*VideoFrameReleaseCallback)(VideoFrame* videoFrame);
+
+struct VideoFrame {
+    void*                     jpegBuffer;
+    unsigned int              jpegBufferLength;
+    unsigned int              jpegBufferCapacity;
+    uint64_t                  uTimestamp;
+    unsigned int              index;
+    atomic_uint               references;
+    VideoFrameReleaseCallback releaseCallback;
+    void*                     owner;
+};
+
+typedef struct VideoFramePool {
+    VideoFrame*     frames;
+    unsigned int    frameCount;
+    VideoFrame**    freeFrames;
+    unsigned int    freeFrameCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t  frameReleased;
+} VideoFramePool;
+
+void            VideoFrameRetain(VideoFrame* videoFrame, unsigned int count);
+void            VideoFrameRelease(VideoFrame* videoFrame);
+VideoFramePool* VideoFramePoolCreate(unsigned int frameCount, unsigned int jpegBufferCapacity);
+VideoFrame*     VideoFramePoolAcquire(VideoFramePool* videoFramePool);
+void            VideoFramePoolFree(VideoFramePool* videoFramePool);
+
+#endif
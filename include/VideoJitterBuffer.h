@@ -0,0 +1,42 @@
+#ifndef VIDEOJITTERBUFFER_H
+#define VIDEOJITTERBUFFER_H
+
+#include "VideoFrame.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VIDEO_JITTER_BUFFER_JITTER_GAIN 16
+#define VIDEO_JITTER_BUFFER_JITTER_MULTIPLIER 4
+#define VIDEO_JITTER_BUFFER_DRIFT_DIVISOR 1024
+#define VIDEO_JITTER_BUFFER_RESET_USECONDS 1000000
+
+typedef struct VideoJitterBuffer {
+    uint64_t        maxDelayUSeconds;
+    uint64_t        frameIntervalUSeconds;
+    unsigned int    capacity;
+    VideoFrame**    frames;
+    uint64_t*       playoutUTimes;
+    unsigned int    head;
+    unsigned int    count;
+    bool            closed;
+    pthread_mutex_t mutex;
+    pthread_cond_t  changed;
+    bool            hasTransit;
+    int64_t         lastTransit;
+    int64_t         baseTransit;
+    uint64_t        jitterUSeconds;
+    uint64_t        excessUSeconds;
+    uint64_t        targetDelayUSeconds;
+    uint64_t        lastPlayoutUTime;
+    uint64_t        lateFrameCount;
+    uint64_t        droppedFrameCount;
+} VideoJitterBuffer;
+
+VideoJitterBuffer* VideoJitterBufferCreate(unsigned int maxDelayMSeconds, unsigned int timebaseNumerator, unsigned int timebaseDenominator);
+VideoFrame*        VideoJitterBufferPush(VideoJitterBuffer* videoJitterBuffer, VideoFrame* videoFrame);
+VideoFrame*        VideoJitterBufferPop(VideoJitterBuffer* videoJitterBuffer);
+void               VideoJitterBufferClose(VideoJitterBuffer* videoJitterBuffer);
+void               VideoJitterBufferFree(VideoJitterBuffer* videoJitterBuffer);
+
+#endif
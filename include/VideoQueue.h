@@ -0,0 +1,31 @@
+#ifndef VIDEOQUEUE_H
+#define VIDEOQUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VIDEO_QUEUE_POLICY_BLOCK 0
+#define VIDEO_QUEUE_POLICY_DROP_OLDEST 1
+#define VIDEO_QUEUE_POLICY_DROP_NEWEST 2
+#define VIDEO_QUEUE_DEFAULT_LENGTH 2
+
+typedef struct VideoQueue {
+    unsigned int     capacity;
+    unsigned int     policy;
+    _Atomic(void*)*  items;
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint32_t event;
+    _Atomic uint32_t waiters;
+    _Atomic bool     closed;
+    _Atomic uint64_t droppedCount;
+} VideoQueue;
+
+VideoQueue* VideoQueueCreate(unsigned int capacity, unsigned int policy);
+void*       VideoQueuePush(VideoQueue* videoQueue, void* item);
+void*       VideoQueuePop(VideoQueue* videoQueue);
+void        VideoQueueClose(VideoQueue* videoQueue);
+void        VideoQueueFree(VideoQueue* videoQueue);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef VIDEORTPJPEG_H
+#define VIDEORTPJPEG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define RTP_VERSION 2
+#define RTP_PAYLOAD_TYPE_JPEG 26
+#define RTP_CLOCK_RATE 90000
+#define RTP_HEADER_LENGTH 12
+#define RTP_JPEG_HEADER_LENGTH 8
+#define RTP_JPEG_RESTART_HEADER_LENGTH 4
+#define RTP_JPEG_QUANTIZATION_HEADER_LENGTH 4
+#define RTP_JPEG_QUANTIZATION_TABLE_LENGTH 64
+#define RTP_JPEG_QUANTIZATION_TABLE_COUNT 2
+#define RTP_JPEG_QUANTIZATION_TABLES_LENGTH (RTP_JPEG_QUANTIZATION_TABLE_COUNT * RTP_JPEG_QUANTIZATION_TABLE_LENGTH)
+#define RTP_MIN_HEADER_LENGTH (RTP_HEADER_LENGTH + RTP_JPEG_HEADER_LENGTH)
+#define RTP_MAX_HEADER_LENGTH (RTP_MIN_HEADER_LENGTH + RTP_JPEG_RESTART_HEADER_LENGTH + RTP_JPEG_QUANTIZATION_HEADER_LENGTH + RTP_JPEG_QUANTIZATION_TABLES_LENGTH)
+#define RTP_JPEG_TYPE_422 0
+#define RTP_JPEG_TYPE_420 1
+#define RTP_JPEG_TYPE_RESTART 64
+#define RTP_JPEG_MAX_QUALITY 99
+#define RTP_JPEG_MIN_DYNAMIC_QUALITY 128
+#define RTP_JPEG_DYNAMIC_QUALITY 255
+#define RTP_JPEG_MAX_DIMENSION 2040
+#define RTP_JPEG_SOI_LENGTH 2
+#define RTP_JPEG_DQT_LENGTH (4 + RTP_JPEG_QUANTIZATION_TABLE_COUNT * (1 + RTP_JPEG_QUANTIZATION_TABLE_LENGTH))
+#define RTP_JPEG_SOF_LENGTH (4 + 6 + 3 * 3)
+#define RTP_JPEG_DHT_LENGTH (4 + 4 * (1 + 16) + 12 + 12 + 162 + 162)
+#define RTP_JPEG_DRI_LENGTH 6
+#define RTP_JPEG_SOS_LENGTH (4 + 1 + 3 * 2 + 3)
+#define RTP_JPEG_EOI_LENGTH 2
+#define RTP_JPEG_HEADERS_LENGTH (RTP_JPEG_SOI_LENGTH + RTP_JPEG_DQT_LENGTH + RTP_JPEG_SOF_LENGTH + RTP_JPEG_DHT_LENGTH + RTP_JPEG_SOS_LENGTH)
+#define RTP_JPEG_MAX_HEADERS_LENGTH (RTP_JPEG_HEADERS_LENGTH + RTP_JPEG_DRI_LENGTH)
+
+typedef struct VideoRTPJPEGFrame {
+    uint8_t  type;
+    uint8_t  quantizationTables[RTP_JPEG_QUANTIZATION_TABLES_LENGTH];
+    uint32_t width;
+    uint32_t height;
+    uint32_t restartInterval;
+    uint32_t scanOffset;
+    uint32_t scanLength;
+} VideoRTPJPEGFrame;
+
+void     VideoRTPJPEGWriteRTPHeader(void* header, bool marker, uint16_t sequence, uint32_t timestamp, uint32_t ssrc);
+bool     VideoRTPJPEGReadRTPHeader(const void* packet, uint32_t packetLength, bool* marker, uint16_t* sequence, uint32_t* timestamp, uint32_t* ssrc, uint32_t* payloadOffset, uint32_t* payloadLength);
+void     VideoRTPJPEGWriteJPEGHeader(void* header, uint32_t fragmentOffset, uint8_t type, uint8_t quality, uint32_t width, uint32_t height);
+void     VideoRTPJPEGReadJPEGHeader(const void* header, uint32_t* fragmentOffset, uint8_t* type, uint8_t* quality, uint32_t* width, uint32_t* height);
+void     VideoRTPJPEGWriteRestartHeader(void* header, uint32_t restartInterval);
+uint32_t VideoRTPJPEGReadRestartHeader(const void* header);
+void     VideoRTPJPEGWriteQuantizationHeader(void* header, const uint8_t* quantizationTables);
+void     VideoRTPJPEGReadQuantizationHeader(const void* header, uint8_t* precision, uint32_t* quantizationTablesLength);
+void     VideoRTPJPEGMakeQuantizationTables(uint8_t quality, uint8_t* quantizationTables);
+uint8_t  VideoRTPJPEGFindQuality(const uint8_t* quantizationTables);
+bool     VideoRTPJPEGParseFrame(const uint8_t* jpeg, uint32_t jpegLength, VideoRTPJPEGFrame* videoRTPJPEGFrame);
+uint32_t VideoRTPJPEGGetHeadersLength(uint32_t restartInterval);
+uint32_t VideoRTPJPEGWriteHeaders(void* jpeg, uint8_t type, const uint8_t* quantizationTables, uint32_t width, uint32_t height, uint32_t restartInterval);
+uint64_t VideoRTPJPEGGetUTimestamp(uint32_t timestamp, uint64_t uNow);
+uint32_t VideoRTPJPEGGetTimestamp(uint64_t uTimestamp);
+
+#endif
\ No newline at end of file
@@ -22,6 +22,8 @@ typedef struct VideoRenderer {
 } VideoRenderer;
 
 VideoRenderer* VideoRendererCreate(unsigned int sourceWidth, unsigned int sourceHeight, unsigned int windowWidth, unsigned int windowHeight, char* windowTitle);
+void           VideoRendererAttachThread(VideoRenderer* videoRenderer);
+void           VideoRendererDetachThread(VideoRenderer* videoRenderer);
 void           VideoRendererRender(VideoRenderer* videoRenderer, void* frame);
 void           VideoRendererFree(VideoRenderer* videoRenderer);
 
@@ -0,0 +1,31 @@
+#ifndef VIDEOSTREAMRECEIVER_H
+#define VIDEOSTREAMRECEIVER_H
+
+#include "VideoFrame.h"
+#include "VideoStreamShared.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+
+typedef struct VideoStreamReceiver {
+    struct sockaddr_storage localAddress;
+    socklen_t               localAddressLength;
+    unsigned int            maxJPEGLength;
+    int                     listenFd;
+    int                     fd;
+    volatile bool           closed;
+    uint8_t                 header[STREAM_HEADER_LENGTH];
+    uint64_t                connectionCount;
+    uint64_t                disconnectionCount;
+    uint64_t                receivedFrameCount;
+    uint64_t                receivedByteCount;
+    uint64_t                invalidFrameCount;
+} VideoStreamReceiver;
+
+VideoStreamReceiver* VideoStreamReceiverCreate(struct sockaddr_storage* localAddress, socklen_t localAddressLength, unsigned int maxJPEGLength);
+VideoFrame*          VideoStreamReceiverReceiveFrame(VideoStreamReceiver* videoStreamReceiver, VideoFramePool* videoFramePool);
+void                 VideoStreamReceiverClose(VideoStreamReceiver* videoStreamReceiver);
+void                 VideoStreamReceiverFree(VideoStreamReceiver* videoStreamReceiver);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef VIDEOSTREAMSENDER_H
+#define VIDEOSTREAMSENDER_H
+
+#include "VideoStreamShared.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+
+#define VIDEO_STREAM_SENDER_DEFAULT_NOTSENT_LOWAT 16384
+#define VIDEO_STREAM_SENDER_TIMEOUT_USECONDS 1000000
+#define VIDEO_STREAM_SENDER_RECONNECT_INTERVAL_USECONDS 1000000
+
+typedef struct VideoStreamSender {
+    struct sockaddr_storage remoteAddress;
+    socklen_t               remoteAddressLength;
+    unsigned int            maxJPEGLength;
+    unsigned int            backlogLength;
+    unsigned int            notSentLowat;
+    int                     fd;
+    uint64_t                reconnectUTime;
+    uint8_t                 header[STREAM_HEADER_LENGTH];
+    unsigned int            queuedByteCount;
+    uint64_t                connectionCount;
+    uint64_t                disconnectionCount;
+    uint64_t                sentFrameCount;
+    uint64_t                sentByteCount;
+    uint64_t                skippedFrameCount;
+    uint64_t                unconnectedFrameCount;
+} VideoStreamSender;
+
+VideoStreamSender* VideoStreamSenderCreate(struct sockaddr_storage* remoteAddress, socklen_t remoteAddressLength, unsigned int maxJPEGLength, unsigned int backlogLength, unsigned int notSentLowat);
+void               VideoStreamSenderSendFrame(VideoStreamSender* videoStreamSender, uint64_t uTimestamp, void* jpeg, unsigned int jpegLength);
+void               VideoStreamSenderFree(VideoStreamSender* videoStreamSender);
+
+#endif
\ No newline at end of file
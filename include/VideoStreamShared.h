@@ -0,0 +1,19 @@
+#ifndef VIDEOSTREAMSHARED_H
+#define VIDEOSTREAMSHARED_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+
+#define STREAM_HEADER_UTIMESTAMP_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define STREAM_HEADER_LENGTH_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define STREAM_HEADER_LENGTH (STREAM_HEADER_UTIMESTAMP_SIZE + STREAM_HEADER_LENGTH_SIZE)
+#define STREAM_HEADER_UTIMESTAMP_OFFSET ((ssize_t)(0))
+#define STREAM_HEADER_LENGTH_OFFSET (STREAM_HEADER_UTIMESTAMP_OFFSET + STREAM_HEADER_UTIMESTAMP_SIZE)
+#define STREAM_UNIX_ADDRESS_PREFIX "unix:"
+
+socklen_t VideoStreamSharedParseAddress(const char* address, struct sockaddr_storage* socketAddress);
+void      VideoStreamSharedWriteHeader(void* header, uint64_t uTimestamp, uint32_t length);
+void      VideoStreamSharedReadHeader(const void* header, uint64_t* uTimestamp, uint32_t* length);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef VIDEOTRANSCODER_H
+#define VIDEOTRANSCODER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <turbojpeg.h>
+
+#define VIDEO_TRANSCODER_YUV_PAD 4
+
+typedef struct VideoTranscoder {
+    tjhandle      decompressHandle;
+    tjhandle      compressHandle;
+    unsigned int  width;
+    unsigned int  height;
+    void*         yuvBuffer;
+    void*         jpegBuffer;
+    unsigned long jpegBufferCapacity;
+    unsigned int  jpegBufferLength;
+} VideoTranscoder;
+
+VideoTranscoder* VideoTranscoderCreate(unsigned int width, unsigned int height);
+bool             VideoTranscoderTranscodeFrame(VideoTranscoder* videoTranscoder, void* jpeg, unsigned int jpegLength, unsigned int quality);
+void             VideoTranscoderFree(VideoTranscoder* videoTranscoder);
+
+#endif
\ No newline at end of file
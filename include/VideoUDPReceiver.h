@@ -1,27 +1,131 @@
 #ifndef VIDEOUDPRECEIVER_H
 #define VIDEOUDPRECEIVER_H
 
+#include "VideoFrame.h"
+#include "VideoRTPJPEG.h"
 #include <netinet/in.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define VIDEO_UDP_RECEIVER_BATCH_LENGTH 64
+#define VIDEO_UDP_RECEIVER_GRO_BATCH_LENGTH 8
+#define VIDEO_UDP_RECEIVER_GRO_BUFFER_LENGTH 65535
+#define VIDEO_UDP_RECEIVER_MAX_NACK_ROUNDS 2
+#define VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT 4
+#define VIDEO_UDP_RECEIVER_MAX_REORDER_USECONDS 1000000
+#define VIDEO_UDP_RECEIVER_JITTER_GAIN 16
+#define VIDEO_UDP_RECEIVER_ROUND_TRIP_GAIN 8
+
+typedef struct VideoUDPReceiverAssembly {
+    bool               active;
+    uint16_t           sequence;
+    uint64_t           uTimestamp;
+    VideoFrame*        videoFrame;
+    bool*              flags;
+    uint32_t           packetCount;
+    uint32_t*          bodyLengths;
+    uint32_t           packetsFlagged;
+    uint32_t           packetsReceived;
+    uint32_t           nextPacketIndex;
+    uint64_t           nackUDeadline;
+    uint64_t           partialUDeadline;
+    uint64_t           openUTime;
+    unsigned int       nackRounds;
+    struct sockaddr_in senderAddress;
+    uint32_t           rtpHeadersLength;
+    uint32_t           rtpScanLength;
+    uint32_t           rtpReceivedLength;
+} VideoUDPReceiverAssembly;
 
 typedef struct VideoUDPReceiver {
-    unsigned int        maxPacketLength;
-    unsigned int        maxJPEGLength;
-    unsigned int        maxPacketBodyLength;
-    unsigned int        maxPacketsPerJPEG;
-    struct sockaddr_in* localAddress;
-    int                 fd;
-    bool*               flags;
-    void*               packet;
-    void*               jpegBuffer;
-    unsigned int        jpegBufferLength;
-    uint64_t            uTimestamp;
+    unsigned int              maxPacketLength;
+    unsigned int              maxJPEGLength;
+    unsigned int              maxPacketBodyLength;
+    unsigned int              maxPacketsPerJPEG;
+    unsigned int              fecPercent;
+    unsigned int              maxParityPacketsPerJPEG;
+    unsigned int              maxSlotsPerJPEG;
+    unsigned int              frameBufferCapacity;
+    unsigned int              width;
+    unsigned int              height;
+    unsigned int              timebaseNumerator;
+    unsigned int              timebaseDenominator;
+    uint8_t                   streamId;
+    uint64_t                  descriptorReceivedCount;
+    bool                      hasSequence;
+    uint16_t                  lastSequence;
+    uint64_t                  missingFrameCount;
+    struct sockaddr_in*       localAddress;
+    bool                      multicast;
+    struct in_addr            multicastInterface;
+    struct in_addr            multicastSource;
+    int                       fd;
+    bool*                     flags;
+    uint32_t*                 bodyLengths;
+    void*                     packets;
+    struct iovec*             iovecs;
+    struct mmsghdr*           messages;
+    bool                      gro;
+    void*                     controls;
+    unsigned int              batchCapacity;
+    unsigned int              batchLength;
+    unsigned int              batchOffset;
+    unsigned int              segmentOffset;
+    uint64_t                  nackDeadlineUSeconds;
+    struct sockaddr_in*       senderAddresses;
+    void*                     nackPacket;
+    uint64_t                  nackSentCount;
+    VideoUDPReceiverAssembly* assemblies;
+    VideoUDPReceiverAssembly* currentAssembly;
+    VideoFrame*               spareFrame;
+    uint64_t                  lastUTimestamp;
+    uint64_t                  incompleteFrameCount;
+    bool                      restart;
+    uint64_t                  restartDeadlineUSeconds;
+    uint64_t                  partialFrameCount;
+    uint64_t                  deliveredFrameCount;
+    uint64_t                  frameIntervalUSeconds;
+    uint64_t                  lateFrameCount;
+    uint64_t                  receivedByteCount;
+    uint64_t                  reportIntervalUSeconds;
+    uint64_t                  reportUDeadline;
+    uint64_t                  lastReportUTime;
+    bool                      hasReportAddress;
+    struct sockaddr_in        reportAddress;
+    uint64_t                  reportedDeliveredCount;
+    uint64_t                  reportedIncompleteCount;
+    uint64_t                  reportedLateCount;
+    uint64_t                  reportedByteCount;
+    uint64_t                  reportSentCount;
+    uint64_t                  expectedPacketCount;
+    uint64_t                  receivedPacketCount;
+    uint64_t                  reportedExpectedPacketCount;
+    uint64_t                  reportedReceivedPacketCount;
+    bool                      hasTransit;
+    int64_t                   lastTransit;
+    uint64_t                  jitterUSeconds;
+    uint64_t                  replyReceivedCount;
+    uint64_t                  roundTripUSeconds;
+    _Atomic int64_t           clockOffsetUSeconds;
+    uint64_t                  oneWayDelayUSeconds;
+    uint64_t                  senderPacketCount;
+    uint64_t                  senderFrameCount;
+    bool                      rtp;
+    bool                      hasRTPSSRC;
+    uint32_t                  rtpSSRC;
+    bool                      hasRTPSequence;
+    uint16_t                  lastRTPSequence;
+    uint8_t                   rtpQuality;
+    uint8_t                   rtpQuantizationTables[RTP_JPEG_QUANTIZATION_TABLES_LENGTH];
+    uint64_t                  unsupportedPacketCount;
 } VideoUDPReceiver;
 
-VideoUDPReceiver* VideoUDPReceiverCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress);
-bool              VideoUDPReceiverReceiveFrame(VideoUDPReceiver* videoUDPReceiver);
+VideoUDPReceiver* VideoUDPReceiverCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, unsigned int width, unsigned int height, unsigned int timebaseNumerator, unsigned int timebaseDenominator, struct sockaddr_in* localAddress, bool gro, unsigned int fecPercent, unsigned int nackDeadlineMSeconds, unsigned int restartDeadlineMSeconds, struct in_addr multicastInterface, struct in_addr multicastSource, unsigned int reportIntervalMSeconds, unsigned int streamId, bool rtp);
+VideoFrame*       VideoUDPReceiverReceiveFrame(VideoUDPReceiver* videoUDPReceiver, VideoFramePool* videoFramePool);
 void              VideoUDPReceiverFree(VideoUDPReceiver* videoUDPReceiver);
 
 #endif
\ No newline at end of file
@@ -2,21 +2,113 @@
 #define VIDEOUDPSENDER_H
 
 #include <netinet/in.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
-typedef struct VideoUDPSender {
-    unsigned int        maxPacketLength;
-    unsigned int        maxJPEGLength;
-    unsigned int        maxPacketBodyLength;
-    unsigned int        maxPacketsPerJPEG;
-    struct sockaddr_in* localAddress;
+#define VIDEO_UDP_SENDER_MAX_BATCH_LENGTH UIO_MAXIOV
+#define VIDEO_UDP_SENDER_MAX_GSO_SEGMENTS 64
+#define VIDEO_UDP_SENDER_MAX_GSO_LENGTH 65507
+#define VIDEO_UDP_SENDER_MAX_ZERO_COPY_FRAGMENTS 17
+#define VIDEO_UDP_SENDER_NACK_TIMEOUT_USECONDS 100000
+#define VIDEO_UDP_SENDER_MAX_DESTINATIONS 64
+#define VIDEO_UDP_SENDER_PACER_KERNEL 0
+#define VIDEO_UDP_SENDER_PACER_USER 1
+#define VIDEO_UDP_SENDER_MAX_QUALITY 100
+#define VIDEO_UDP_SENDER_QUALITY_STEP 5
+#define VIDEO_UDP_SENDER_QUALITY_BACKOFF_PERCENT 75
+#define VIDEO_UDP_SENDER_MAX_LOSS_PERMILLE 20
+#define VIDEO_UDP_SENDER_DESCRIPTOR_INTERVAL_USECONDS 1000000
+
+typedef struct VideoUDPSenderDestination {
     struct sockaddr_in* remoteAddress;
-    int                 fd;
-    void*               packet;
+    _Atomic uint64_t    sentByteCount;
+    _Atomic uint64_t    sentPacketCount;
+    uint64_t            sendErrorCount;
+    uint64_t            droppedPacketCount;
+    _Atomic uint64_t    reportReceivedCount;
+    _Atomic uint64_t    reportExpectedPacketCount;
+    _Atomic uint64_t    reportLostPacketCount;
+    _Atomic uint64_t    reportPacketLossPermille;
+    _Atomic uint64_t    reportJitterUSeconds;
+    _Atomic uint64_t    reportRoundTripUSeconds;
+    _Atomic int64_t     reportClockOffsetUSeconds;
+} VideoUDPSenderDestination;
+
+typedef struct VideoUDPSender {
+    unsigned int               maxPacketLength;
+    unsigned int               maxJPEGLength;
+    unsigned int               maxPacketBodyLength;
+    unsigned int               maxPacketsPerJPEG;
+    unsigned int               fecPercent;
+    unsigned int               maxParityPacketsPerJPEG;
+    struct sockaddr_in*        localAddress;
+    VideoUDPSenderDestination* destinations;
+    unsigned int               destinationCount;
+    bool                       multicast;
+    unsigned int               multicastTTL;
+    struct in_addr             multicastInterface;
+    uint8_t                    streamId;
+    uint16_t                   sequence;
+    unsigned int               width;
+    unsigned int               height;
+    unsigned int               timebaseNumerator;
+    unsigned int               timebaseDenominator;
+    uint64_t                   descriptorNDeadline;
+    uint64_t                   descriptorSentCount;
+    int                        fd;
+    bool                       restart;
+    unsigned int               headerLength;
+    void*                      headers;
+    uint32_t*                  packetOffsets;
+    uint32_t*                  packetLengths;
+    void*                      parityBodies;
+    struct iovec*              iovecs;
+    struct mmsghdr*            messages;
+    bool                       gso;
+    unsigned int               packetsPerMessage;
+    unsigned int               zeroCopyThreshold;
+    uint64_t                   zeroCopySentCount;
+    uint64_t                   zeroCopyCompletedCount;
+    uint64_t                   zeroCopyCopiedCount;
+    unsigned int               nackCacheLength;
+    void*                      nackCacheJPEGs;
+    uint64_t*                  nackCacheUTimestamps;
+    unsigned int*              nackCacheJPEGLengths;
+    unsigned int               nackCacheHead;
+    pthread_mutex_t            nackCacheMutex;
+    pthread_t                  controlThread;
+    _Atomic bool               controlThreadRunning;
+    void*                      controlPacket;
+    uint32_t*                  nackPacketOffsets;
+    uint32_t*                  nackPacketLengths;
+    void*                      nackPacketPrefixes;
+    _Atomic uint64_t           nackReceivedCount;
+    _Atomic uint64_t           nackResentCount;
+    unsigned int               pacePercent;
+    uint64_t                   paceWindowNSeconds;
+    unsigned int               pacer;
+    void*                      paceControls;
+    uint64_t*                  launchNSeconds;
+    bool                       report;
+    _Atomic uint64_t           sentFrameCount;
+    unsigned int               minQuality;
+    _Atomic unsigned int       quality;
+    _Atomic uint64_t           reportReceivedCount;
+    _Atomic uint64_t           reportLossPermille;
+    _Atomic uint64_t           reportLateCount;
+    _Atomic uint64_t           reportGoodput;
+    bool                       rtp;
+    uint16_t                   rtpSequence;
+    uint32_t                   rtpSSRC;
+    uint64_t                   unsupportedFrameCount;
 } VideoUDPSender;
 
-VideoUDPSender* VideoUDPSenderCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress, struct sockaddr_in* remoteAddress);
+VideoUDPSender* VideoUDPSenderCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress, struct sockaddr_in* remoteAddresses, unsigned int remoteAddressCount, unsigned int zeroCopyThreshold, bool gso, unsigned int fecPercent, unsigned int nackCacheLength, bool restart, unsigned int multicastTTL, struct in_addr multicastInterface, unsigned int pacePercent, unsigned int pacer, unsigned int width, unsigned int height, unsigned int timebaseNumerator, unsigned int timebaseDenominator, unsigned int minQuality, bool report, unsigned int streamId, bool rtp);
 void            VideoUDPSenderSendFrame(VideoUDPSender* videoUDPSender, uint64_t uTimestamp, void* jpeg, unsigned int jpegLength, unsigned int sendRounds);
 void            VideoUDPSenderFree(VideoUDPSender* videoUDPSender);
 
@@ -3,18 +3,110 @@
 
 #include <netinet/in.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 
+#define HEADER_VERSION 1
+#define HEADER_VERSION_SIZE ((ssize_t)(sizeof(uint8_t)))
+#define HEADER_STREAM_ID_SIZE ((ssize_t)(sizeof(uint8_t)))
+#define HEADER_SEQUENCE_SIZE ((ssize_t)(sizeof(uint16_t)))
 #define HEADER_UTIMESTAMP_SIZE ((ssize_t)(sizeof(uint64_t)))
-#define HEADER_PACKET_INDEX_SIZE ((ssize_t)(sizeof(uint32_t)))
-#define HEADER_PACKET_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
-#define HEADER_BODY_LENGTH_SIZE ((ssize_t)(sizeof(uint32_t)))
-#define HEADER_LENGTH (HEADER_UTIMESTAMP_SIZE + HEADER_PACKET_INDEX_SIZE + HEADER_PACKET_COUNT_SIZE + HEADER_BODY_LENGTH_SIZE)
-#define HEADER_UTIMESTAMP_OFFSET ((ssize_t)(0))
-#define HEADER_PACKET_INDEX_OFFSET (HEADER_UTIMESTAMP_SIZE)
+#define HEADER_PACKET_INDEX_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define HEADER_PACKET_COUNT_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define HEADER_BODY_LENGTH_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define HEADER_LENGTH (HEADER_VERSION_SIZE + HEADER_STREAM_ID_SIZE + HEADER_SEQUENCE_SIZE + HEADER_UTIMESTAMP_SIZE + HEADER_PACKET_INDEX_SIZE + HEADER_PACKET_COUNT_SIZE + HEADER_BODY_LENGTH_SIZE)
+#define HEADER_VERSION_OFFSET ((ssize_t)(0))
+#define HEADER_STREAM_ID_OFFSET (HEADER_VERSION_OFFSET + HEADER_VERSION_SIZE)
+#define HEADER_SEQUENCE_OFFSET (HEADER_STREAM_ID_OFFSET + HEADER_STREAM_ID_SIZE)
+#define HEADER_UTIMESTAMP_OFFSET (HEADER_SEQUENCE_OFFSET + HEADER_SEQUENCE_SIZE)
+#define HEADER_PACKET_INDEX_OFFSET (HEADER_UTIMESTAMP_OFFSET + HEADER_UTIMESTAMP_SIZE)
 #define HEADER_PACKET_COUNT_OFFSET (HEADER_PACKET_INDEX_OFFSET + HEADER_PACKET_INDEX_SIZE)
 #define HEADER_BODY_LENGTH_OFFSET (HEADER_PACKET_COUNT_OFFSET + HEADER_PACKET_COUNT_SIZE)
 #define PACKET_BODY_START_OFFSET (HEADER_BODY_LENGTH_OFFSET + HEADER_BODY_LENGTH_SIZE)
+#define MAX_HEADER_FIELD UINT16_MAX
+#define MAX_STREAM_ID UINT8_MAX
+#define MAX_FEC_PERCENT 100
+#define CONTROL_PACKET_COUNT 0
+#define CONTROL_TYPE_NACK 0
+#define CONTROL_TYPE_REPORT 1
+#define CONTROL_TYPE_REPLY 2
+#define CONTROL_TYPE_DESCRIPTOR 3
+#define REPORT_SEND_UTIME_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPORT_DELIVERED_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_LOST_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_LATE_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_BYTE_COUNT_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPORT_USECONDS_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_EXPECTED_PACKET_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_LOST_PACKET_COUNT_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_JITTER_USECONDS_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_ROUND_TRIP_USECONDS_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define REPORT_CLOCK_OFFSET_USECONDS_SIZE ((ssize_t)(sizeof(int64_t)))
+#define REPORT_LENGTH (REPORT_SEND_UTIME_SIZE + REPORT_DELIVERED_COUNT_SIZE + REPORT_LOST_COUNT_SIZE + REPORT_LATE_COUNT_SIZE + REPORT_BYTE_COUNT_SIZE + REPORT_USECONDS_SIZE + REPORT_EXPECTED_PACKET_COUNT_SIZE + REPORT_LOST_PACKET_COUNT_SIZE + REPORT_JITTER_USECONDS_SIZE + REPORT_ROUND_TRIP_USECONDS_SIZE + REPORT_CLOCK_OFFSET_USECONDS_SIZE)
+#define REPORT_SEND_UTIME_OFFSET ((ssize_t)(0))
+#define REPORT_DELIVERED_COUNT_OFFSET (REPORT_SEND_UTIME_OFFSET + REPORT_SEND_UTIME_SIZE)
+#define REPORT_LOST_COUNT_OFFSET (REPORT_DELIVERED_COUNT_OFFSET + REPORT_DELIVERED_COUNT_SIZE)
+#define REPORT_LATE_COUNT_OFFSET (REPORT_LOST_COUNT_OFFSET + REPORT_LOST_COUNT_SIZE)
+#define REPORT_BYTE_COUNT_OFFSET (REPORT_LATE_COUNT_OFFSET + REPORT_LATE_COUNT_SIZE)
+#define REPORT_USECONDS_OFFSET (REPORT_BYTE_COUNT_OFFSET + REPORT_BYTE_COUNT_SIZE)
+#define REPORT_EXPECTED_PACKET_COUNT_OFFSET (REPORT_USECONDS_OFFSET + REPORT_USECONDS_SIZE)
+#define REPORT_LOST_PACKET_COUNT_OFFSET (REPORT_EXPECTED_PACKET_COUNT_OFFSET + REPORT_EXPECTED_PACKET_COUNT_SIZE)
+#define REPORT_JITTER_USECONDS_OFFSET (REPORT_LOST_PACKET_COUNT_OFFSET + REPORT_LOST_PACKET_COUNT_SIZE)
+#define REPORT_ROUND_TRIP_USECONDS_OFFSET (REPORT_JITTER_USECONDS_OFFSET + REPORT_JITTER_USECONDS_SIZE)
+#define REPORT_CLOCK_OFFSET_USECONDS_OFFSET (REPORT_ROUND_TRIP_USECONDS_OFFSET + REPORT_ROUND_TRIP_USECONDS_SIZE)
+#define REPLY_ECHO_UTIME_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPLY_RECEIVE_UTIME_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPLY_SEND_UTIME_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPLY_SENT_PACKET_COUNT_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPLY_SENT_FRAME_COUNT_SIZE ((ssize_t)(sizeof(uint64_t)))
+#define REPLY_LENGTH (REPLY_ECHO_UTIME_SIZE + REPLY_RECEIVE_UTIME_SIZE + REPLY_SEND_UTIME_SIZE + REPLY_SENT_PACKET_COUNT_SIZE + REPLY_SENT_FRAME_COUNT_SIZE)
+#define REPLY_ECHO_UTIME_OFFSET ((ssize_t)(0))
+#define REPLY_RECEIVE_UTIME_OFFSET (REPLY_ECHO_UTIME_OFFSET + REPLY_ECHO_UTIME_SIZE)
+#define REPLY_SEND_UTIME_OFFSET (REPLY_RECEIVE_UTIME_OFFSET + REPLY_RECEIVE_UTIME_SIZE)
+#define REPLY_SENT_PACKET_COUNT_OFFSET (REPLY_SEND_UTIME_OFFSET + REPLY_SEND_UTIME_SIZE)
+#define REPLY_SENT_FRAME_COUNT_OFFSET (REPLY_SENT_PACKET_COUNT_OFFSET + REPLY_SENT_PACKET_COUNT_SIZE)
+#define DESCRIPTOR_MAX_PACKET_LENGTH_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define DESCRIPTOR_MAX_JPEG_LENGTH_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define DESCRIPTOR_WIDTH_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define DESCRIPTOR_HEIGHT_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define DESCRIPTOR_TIMEBASE_NUMERATOR_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define DESCRIPTOR_TIMEBASE_DENOMINATOR_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define DESCRIPTOR_FEC_PERCENT_SIZE ((ssize_t)(sizeof(uint8_t)))
+#define DESCRIPTOR_FLAGS_SIZE ((ssize_t)(sizeof(uint8_t)))
+#define DESCRIPTOR_LENGTH (DESCRIPTOR_MAX_PACKET_LENGTH_SIZE + DESCRIPTOR_MAX_JPEG_LENGTH_SIZE + DESCRIPTOR_WIDTH_SIZE + DESCRIPTOR_HEIGHT_SIZE + DESCRIPTOR_TIMEBASE_NUMERATOR_SIZE + DESCRIPTOR_TIMEBASE_DENOMINATOR_SIZE + DESCRIPTOR_FEC_PERCENT_SIZE + DESCRIPTOR_FLAGS_SIZE)
+#define DESCRIPTOR_MAX_PACKET_LENGTH_OFFSET ((ssize_t)(0))
+#define DESCRIPTOR_MAX_JPEG_LENGTH_OFFSET (DESCRIPTOR_MAX_PACKET_LENGTH_OFFSET + DESCRIPTOR_MAX_PACKET_LENGTH_SIZE)
+#define DESCRIPTOR_WIDTH_OFFSET (DESCRIPTOR_MAX_JPEG_LENGTH_OFFSET + DESCRIPTOR_MAX_JPEG_LENGTH_SIZE)
+#define DESCRIPTOR_HEIGHT_OFFSET (DESCRIPTOR_WIDTH_OFFSET + DESCRIPTOR_WIDTH_SIZE)
+#define DESCRIPTOR_TIMEBASE_NUMERATOR_OFFSET (DESCRIPTOR_HEIGHT_OFFSET + DESCRIPTOR_HEIGHT_SIZE)
+#define DESCRIPTOR_TIMEBASE_DENOMINATOR_OFFSET (DESCRIPTOR_TIMEBASE_NUMERATOR_OFFSET + DESCRIPTOR_TIMEBASE_NUMERATOR_SIZE)
+#define DESCRIPTOR_FEC_PERCENT_OFFSET (DESCRIPTOR_TIMEBASE_DENOMINATOR_OFFSET + DESCRIPTOR_TIMEBASE_DENOMINATOR_SIZE)
+#define DESCRIPTOR_FLAGS_OFFSET (DESCRIPTOR_FEC_PERCENT_OFFSET + DESCRIPTOR_FEC_PERCENT_SIZE)
+#define DESCRIPTOR_FLAG_RESTART 1
+#define RESTART_PREFIX_INTERVAL_SIZE ((ssize_t)(sizeof(uint32_t)))
+#define RESTART_PREFIX_MARKER_COUNT_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define RESTART_PREFIX_FLAGS_SIZE ((ssize_t)(sizeof(uint16_t)))
+#define RESTART_PREFIX_LENGTH (RESTART_PREFIX_INTERVAL_SIZE + RESTART_PREFIX_MARKER_COUNT_SIZE + RESTART_PREFIX_FLAGS_SIZE)
+#define RESTART_PREFIX_INTERVAL_OFFSET ((ssize_t)(0))
+#define RESTART_PREFIX_MARKER_COUNT_OFFSET (RESTART_PREFIX_INTERVAL_SIZE)
+#define RESTART_PREFIX_FLAGS_OFFSET (RESTART_PREFIX_MARKER_COUNT_OFFSET + RESTART_PREFIX_MARKER_COUNT_SIZE)
+#define RESTART_PREFIX_FLAG_BOUNDARY 1
 
-int VideoUDPSharedCreateSocket(struct sockaddr_in* localAddress);
+int      VideoUDPSharedCreateSocket(struct sockaddr_in* localAddress);
+void     VideoUDPSharedWriteHeader(void* header, uint8_t streamId, uint16_t sequence, uint64_t uTimestamp, uint32_t packetIndex, uint32_t packetCount, uint32_t packetBodyLength);
+bool     VideoUDPSharedReadHeader(const void* header, uint8_t* streamId, uint16_t* sequence, uint64_t* uTimestamp, uint32_t* packetIndex, uint32_t* packetCount, uint32_t* packetBodyLength);
+void     VideoUDPSharedWriteRestartPrefix(void* prefix, uint32_t firstInterval, uint16_t markerCount, bool boundary);
+void     VideoUDPSharedReadRestartPrefix(const void* prefix, uint32_t* firstInterval, uint16_t* markerCount, bool* boundary);
+void     VideoUDPSharedWriteReport(void* report, uint64_t sendUTime, uint32_t deliveredCount, uint32_t lostCount, uint32_t lateCount, uint64_t byteCount, uint32_t uSeconds, uint32_t expectedPacketCount, uint32_t lostPacketCount, uint32_t jitterUSeconds, uint32_t roundTripUSeconds, int64_t clockOffsetUSeconds);
+void     VideoUDPSharedReadReport(const void* report, uint64_t* sendUTime, uint32_t* deliveredCount, uint32_t* lostCount, uint32_t* lateCount, uint64_t* byteCount, uint32_t* uSeconds, uint32_t* expectedPacketCount, uint32_t* lostPacketCount, uint32_t* jitterUSeconds, uint32_t* roundTripUSeconds, int64_t* clockOffsetUSeconds);
+void     VideoUDPSharedWriteReply(void* reply, uint64_t echoUTime, uint64_t receiveUTime, uint64_t sendUTime, uint64_t sentPacketCount, uint64_t sentFrameCount);
+void     VideoUDPSharedReadReply(const void* reply, uint64_t* echoUTime, uint64_t* receiveUTime, uint64_t* sendUTime, uint64_t* sentPacketCount, uint64_t* sentFrameCount);
+void     VideoUDPSharedWriteDescriptor(void* descriptor, uint32_t maxPacketLength, uint32_t maxJPEGLength, uint32_t width, uint32_t height, uint32_t timebaseNumerator, uint32_t timebaseDenominator, uint32_t fecPercent, bool restart);
+void     VideoUDPSharedReadDescriptor(const void* descriptor, uint32_t* maxPacketLength, uint32_t* maxJPEGLength, uint32_t* width, uint32_t* height, uint32_t* timebaseNumerator, uint32_t* timebaseDenominator, uint32_t* fecPercent, bool* restart);
+uint64_t VideoUDPSharedGetEpochUSeconds();
+uint32_t VideoUDPSharedFindRestartMarkerEnd(const uint8_t* data, uint32_t start, uint32_t end);
+uint32_t VideoUDPSharedGetMaxPacketCount(unsigned int maxJPEGLength, unsigned int maxPacketBodyLength, bool restart);
+uint32_t VideoUDPSharedGetParityPacketCount(uint32_t packetCount, unsigned int fecPercent);
+void     VideoUDPSharedXOR(void* destination, const void* source, size_t length);
 
 #endif
\ No newline at end of file
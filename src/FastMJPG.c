@@ -1,10 +1,18 @@
 #include "../include/VideoCapture.h"
 #include "../include/VideoDecoder.h"
+#include "../include/VideoFrame.h"
+#include "../include/VideoJitterBuffer.h"
 #include "../include/VideoPipe.h"
+#include "../include/VideoQueue.h"
 #include "../include/VideoRecorder.h"
 #include "../include/VideoRenderer.h"
+#include "../include/VideoStreamReceiver.h"
+#include "../include/VideoStreamSender.h"
+#include "../include/VideoStreamShared.h"
+#include "../include/VideoTranscoder.h"
 #include "../include/VideoUDPReceiver.h"
 #include "../include/VideoUDPSender.h"
+#include "../include/VideoUDPShared.h"
 #include <arpa/inet.h>
 #include <dirent.h>
 #include <errno.h>
@@ -30,6 +38,8 @@
 #define PARAM_TYPE_RECORD 3
 #define PARAM_TYPE_SEND 4
 #define PARAM_TYPE_PIPE 5
+#define PARAM_TYPE_STREAM_RECEIVE 6
+#define PARAM_TYPE_STREAM_SEND 7
 
 typedef struct CaptureParams {
     char*         deviceName;
@@ -37,6 +47,8 @@ typedef struct CaptureParams {
     unsigned int  resolutionHeight;
     unsigned int  timebaseNumerator;
     unsigned int  timebaseDenominator;
+    unsigned int  bufferCount;
+    bool          latest;
     VideoCapture* videoCapture;
 } CaptureParams;
 
@@ -46,19 +58,29 @@ typedef struct ReceiveParams {
     struct sockaddr_in* localAddress;
     unsigned int        maxPacketLength;
     unsigned int        maxJPEGLength;
-    void*               jpegBuffer;
-    unsigned int        jpegBufferLength;
     unsigned int        resolutionWidth;
     unsigned int        resolutionHeight;
     unsigned int        timebaseNumerator;
     unsigned int        timebaseDenominator;
+    bool                gro;
+    unsigned int        fecPercent;
+    unsigned int        nackDeadlineMSeconds;
+    unsigned int        restartDeadlineMSeconds;
+    unsigned int        jitterMaxDelayMSeconds;
+    char*               multicastInterfaceIPAddress;
+    char*               multicastSourceIPAddress;
+    unsigned int        reportIntervalMSeconds;
+    unsigned int        streamId;
+    bool                rtp;
     VideoUDPReceiver*   videoUDPReceiver;
+    VideoJitterBuffer*  videoJitterBuffer;
 } ReceiveParams;
 
 typedef struct RenderParams {
     unsigned int   windowWidth;
     unsigned int   windowHeight;
     VideoRenderer* videoRenderer;
+    VideoDecoder*  videoDecoder;
 } RenderParams;
 
 typedef struct RecordParams {
@@ -72,34 +94,87 @@ typedef struct SendParams {
     struct sockaddr_in* localAddress;
     char*               remoteIPAddress;
     unsigned int        remotePort;
-    struct sockaddr_in* remoteAddress;
+    struct sockaddr_in* remoteAddresses;
+    unsigned int        remoteAddressCount;
     unsigned int        maxPacketLength;
     unsigned int        maxJPEGLength;
     unsigned int        sendRounds;
+    unsigned int        zeroCopyThreshold;
+    bool                gso;
+    unsigned int        fecPercent;
+    unsigned int        nackCacheLength;
+    bool                restart;
+    unsigned int        multicastTTL;
+    char*               multicastInterfaceIPAddress;
+    unsigned int        pacePercent;
+    unsigned int        pacer;
+    unsigned int        minQuality;
+    bool                report;
+    unsigned int        streamId;
+    bool                rtp;
     VideoUDPSender*     videoUDPSender;
+    VideoTranscoder*    videoTranscoder;
 } SendParams;
 
 typedef struct PipeParams {
-    int          pipeFileDescriptor;
-    char*        rgbOrJPEG;
-    bool         rgb;
-    unsigned int maxPacketLength;
-    VideoPipe*   videoPipe;
+    int           pipeFileDescriptor;
+    char*         rgbOrJPEG;
+    bool          rgb;
+    unsigned int  maxPacketLength;
+    VideoPipe*    videoPipe;
+    VideoDecoder* videoDecoder;
 } PipeParams;
 
-static void*         params[MAX_PARAMS];
-static unsigned int  paramsTypes[MAX_PARAMS];
-static unsigned int  paramsCount               = 0;
-static unsigned int  sourceWidth               = 0;
-static unsigned int  sourceHeight              = 0;
-static unsigned int  sourceTimebaseNumerator   = 0;
-static unsigned int  sourceTimebaseDenominator = 0;
-static char*         renderWindowTitle         = NULL;
-static uint64_t      uTimestamp                = 0;
-static void*         jpegBuffer                = NULL;
-static unsigned int  jpegBufferLength          = 0;
-static VideoDecoder* videoDecoder              = NULL;
-static bool          receivedSigint            = false;
+typedef struct StreamReceiveParams {
+    char*                   localAddressName;
+    struct sockaddr_storage localAddress;
+    socklen_t               localAddressLength;
+    unsigned int            maxJPEGLength;
+    unsigned int            resolutionWidth;
+    unsigned int            resolutionHeight;
+    unsigned int            timebaseNumerator;
+    unsigned int            timebaseDenominator;
+    VideoStreamReceiver*    videoStreamReceiver;
+} StreamReceiveParams;
+
+typedef struct StreamSendParams {
+    char*                   remoteAddressName;
+    struct sockaddr_storage remoteAddress;
+    socklen_t               remoteAddressLength;
+    unsigned int            maxJPEGLength;
+    unsigned int            backlogLength;
+    unsigned int            notSentLowat;
+    VideoStreamSender*      videoStreamSender;
+} StreamSendParams;
+
+static void*           params[MAX_PARAMS];
+static unsigned int    paramsTypes[MAX_PARAMS];
+static VideoQueue*     paramsQueues[MAX_PARAMS];
+static unsigned int    paramsQueuePolicies[MAX_PARAMS];
+static unsigned int    paramsQueueLengths[MAX_PARAMS];
+static pthread_t       paramsThreads[MAX_PARAMS];
+static pthread_t       playoutThread;
+static unsigned int    paramsCount               = 0;
+static unsigned int    sourceWidth               = 0;
+static unsigned int    sourceHeight              = 0;
+static unsigned int    sourceTimebaseNumerator   = 0;
+static unsigned int    sourceTimebaseDenominator = 0;
+static char*           renderWindowTitle         = NULL;
+static VideoFramePool* videoFramePool            = NULL;
+static bool            receivedSigint            = false;
+
+static inline const char* queuePolicyName(unsigned int queuePolicy) {
+    switch (queuePolicy) {
+        case VIDEO_QUEUE_POLICY_BLOCK:
+            return "block";
+        case VIDEO_QUEUE_POLICY_DROP_OLDEST:
+            return "drop-oldest";
+        case VIDEO_QUEUE_POLICY_DROP_NEWEST:
+            return "drop-newest";
+        default:
+            return "unknown";
+    }
+}
 
 #ifdef MEASURE
 
@@ -161,13 +236,20 @@ static inline void createMetrics() {
     totalFrameCount = 0;
 }
 
-static inline void paramsMetricsStart(unsigned int paramIndex) {
+static inline uint64_t sourceNow() {
+    if (paramsTypes[0] == PARAM_TYPE_RECEIVE) {
+        return now() + atomic_load(&((ReceiveParams*)params[0])->videoUDPReceiver->clockOffsetUSeconds);
+    }
+    return now();
+}
+
+static inline void paramsMetricsStart(unsigned int paramIndex, uint64_t uTimestamp) {
     Metrics* paramMetrics = paramsMetrics[paramIndex];
     paramMetrics->count++;
     if (paramIndex == 0) {
         paramMetrics->startLast = 0;
     } else {
-        paramMetrics->startLast = now() - uTimestamp;
+        paramMetrics->startLast = sourceNow() - uTimestamp;
         paramMetrics->startTotal += paramMetrics->startLast;
         paramMetrics->startAverage = paramMetrics->startTotal / paramMetrics->count;
         if (paramMetrics->startLast < paramMetrics->startMin) {
@@ -179,9 +261,9 @@ static inline void paramsMetricsStart(unsigned int paramIndex) {
     }
 }
 
-static inline void paramsMetricsEnd(unsigned int paramIndex) {
+static inline void paramsMetricsEnd(unsigned int paramIndex, uint64_t uTimestamp) {
     Metrics* paramMetrics = paramsMetrics[paramIndex];
-    paramMetrics->endLast = now() - uTimestamp;
+    paramMetrics->endLast = sourceNow() - uTimestamp;
     paramMetrics->endTotal += paramMetrics->endLast;
     paramMetrics->endAverage = paramMetrics->endTotal / paramMetrics->count;
     if (paramMetrics->endLast < paramMetrics->endMin) {
@@ -224,6 +306,10 @@ static inline void printParam(unsigned int paramIndex) {
             printf("    Resolution Height:    %u\n", captureParams->resolutionHeight);
             printf("    Timebase Numerator:   %u\n", captureParams->timebaseNumerator);
             printf("    Timebase Denominator: %u\n", captureParams->timebaseDenominator);
+            printf("    Buffer Count:         %u\n", captureParams->videoCapture->frameCount);
+            printf("    Latest:               %s\n", captureParams->latest ? "true" : "false");
+            printf("    Dropped Frames:       %lu\n", captureParams->videoCapture->droppedFrameCount);
+            printf("    Skipped Frames:       %lu\n", captureParams->videoCapture->skippedFrameCount);
             break;
         case PARAM_TYPE_RECEIVE:
             ReceiveParams* receiveParams = params[paramIndex];
@@ -236,6 +322,40 @@ static inline void printParam(unsigned int paramIndex) {
             printf("    Resolution Height:    %u\n", receiveParams->resolutionHeight);
             printf("    Timebase Numerator:   %u\n", receiveParams->timebaseNumerator);
             printf("    Timebase Denominator: %u\n", receiveParams->timebaseDenominator);
+            printf("    GRO:                  %s\n", receiveParams->gro ? "true" : "false");
+            printf("    FEC Percent:          %u\n", receiveParams->fecPercent);
+            printf("    NACK Deadline:        %u ms\n", receiveParams->nackDeadlineMSeconds);
+            printf("    NACKs Sent:           %lu\n", receiveParams->videoUDPReceiver->nackSentCount);
+            printf("    Incomplete Frames:    %lu\n", receiveParams->videoUDPReceiver->incompleteFrameCount);
+            printf("    Restart Deadline:     %u ms\n", receiveParams->restartDeadlineMSeconds);
+            printf("    Partial Frames:       %lu\n", receiveParams->videoUDPReceiver->partialFrameCount);
+            printf("    Jitter Max Delay:     %u ms\n", receiveParams->jitterMaxDelayMSeconds);
+            printf("    Multicast Interface:  %s\n", receiveParams->multicastInterfaceIPAddress != NULL ? receiveParams->multicastInterfaceIPAddress : "default");
+            printf("    Multicast Source:     %s\n", receiveParams->multicastSourceIPAddress != NULL ? receiveParams->multicastSourceIPAddress : "any");
+            printf("    Report Interval:      %u ms\n", receiveParams->reportIntervalMSeconds);
+            printf("    Reports Sent:         %lu\n", receiveParams->videoUDPReceiver->reportSentCount);
+            printf("    Delivered Frames:     %lu\n", receiveParams->videoUDPReceiver->deliveredFrameCount);
+            printf("    Late Frames:          %lu\n", receiveParams->videoUDPReceiver->lateFrameCount);
+            printf("    Expected Packets:     %lu\n", receiveParams->videoUDPReceiver->expectedPacketCount);
+            printf("    Lost Packets:         %lu\n", receiveParams->videoUDPReceiver->expectedPacketCount - receiveParams->videoUDPReceiver->receivedPacketCount);
+            printf("    Arrival Jitter:       %lu us\n", receiveParams->videoUDPReceiver->jitterUSeconds);
+            printf("    Replies Received:     %lu\n", receiveParams->videoUDPReceiver->replyReceivedCount);
+            printf("    Round Trip:           %lu us\n", receiveParams->videoUDPReceiver->roundTripUSeconds);
+            printf("    Clock Offset:         %ld us\n", atomic_load(&receiveParams->videoUDPReceiver->clockOffsetUSeconds));
+            printf("    One-Way Delay:        %lu us\n", receiveParams->videoUDPReceiver->oneWayDelayUSeconds);
+            printf("    Sender Packets:       %lu\n", receiveParams->videoUDPReceiver->senderPacketCount);
+            printf("    Sender Frames:        %lu\n", receiveParams->videoUDPReceiver->senderFrameCount);
+            printf("    Stream ID:            %u\n", receiveParams->streamId);
+            printf("    Descriptors Received: %lu\n", receiveParams->videoUDPReceiver->descriptorReceivedCount);
+            printf("    Missing Frames:       %lu\n", receiveParams->videoUDPReceiver->missingFrameCount);
+            printf("    RTP:                  %s\n", receiveParams->rtp ? "true" : "false");
+            printf("    Unsupported Packets:  %lu\n", receiveParams->videoUDPReceiver->unsupportedPacketCount);
+            if (receiveParams->videoJitterBuffer != NULL) {
+                printf("    Jitter:               %lu us\n", receiveParams->videoJitterBuffer->jitterUSeconds);
+                printf("    Jitter Target Delay:  %lu us\n", receiveParams->videoJitterBuffer->targetDelayUSeconds);
+                printf("    Jitter Late Frames:   %lu\n", receiveParams->videoJitterBuffer->lateFrameCount);
+                printf("    Jitter Dropped:       %lu\n", receiveParams->videoJitterBuffer->droppedFrameCount);
+            }
             break;
         case PARAM_TYPE_RENDER:
             RenderParams* renderParams = params[paramIndex];
@@ -258,6 +378,47 @@ static inline void printParam(unsigned int paramIndex) {
             printf("    Max Packet Length:    %u\n", sendParams->maxPacketLength);
             printf("    Max JPEG Length:      %u\n", sendParams->maxJPEGLength);
             printf("    Send Rounds:          %u\n", sendParams->sendRounds);
+            printf("    Zero Copy Threshold:  %u\n", sendParams->zeroCopyThreshold);
+            printf("    GSO:                  %s\n", sendParams->gso ? "true" : "false");
+            printf("    FEC Percent:          %u\n", sendParams->fecPercent);
+            printf("    Zero Copy Sends:      %lu\n", sendParams->videoUDPSender->zeroCopySentCount);
+            printf("    Zero Copy Copied:     %lu\n", sendParams->videoUDPSender->zeroCopyCopiedCount);
+            printf("    NACK Cache Length:    %u\n", sendParams->nackCacheLength);
+            printf("    Restart:              %s\n", sendParams->restart ? "true" : "false");
+            printf("    Stream ID:            %u\n", sendParams->streamId);
+            printf("    Descriptors Sent:     %lu\n", sendParams->videoUDPSender->descriptorSentCount);
+            printf("    RTP:                  %s\n", sendParams->rtp ? "true" : "false");
+            printf("    Unsupported Frames:   %lu\n", sendParams->videoUDPSender->unsupportedFrameCount);
+            for (unsigned int destinationIndex = 0; destinationIndex < sendParams->videoUDPSender->destinationCount; destinationIndex++) {
+                VideoUDPSenderDestination* destination = &sendParams->videoUDPSender->destinations[destinationIndex];
+                char                       ipAddress[INET_ADDRSTRLEN];
+                inet_ntop(AF_INET, &destination->remoteAddress->sin_addr, ipAddress, sizeof(ipAddress));
+                printf("    Destination %-9u %s:%u\n", destinationIndex, ipAddress, ntohs(destination->remoteAddress->sin_port));
+                printf("        Bytes Sent:       %lu\n", atomic_load(&destination->sentByteCount));
+                printf("        Send Errors:      %lu\n", destination->sendErrorCount);
+                printf("        Dropped Packets:  %lu\n", destination->droppedPacketCount);
+                printf("        Packets Sent:     %lu\n", atomic_load(&destination->sentPacketCount));
+                printf("        Reports:          %lu\n", atomic_load(&destination->reportReceivedCount));
+                printf("        Expected Packets: %lu\n", atomic_load(&destination->reportExpectedPacketCount));
+                printf("        Lost Packets:     %lu\n", atomic_load(&destination->reportLostPacketCount));
+                printf("        Packet Loss:      %lu per mille\n", atomic_load(&destination->reportPacketLossPermille));
+                printf("        Arrival Jitter:   %lu us\n", atomic_load(&destination->reportJitterUSeconds));
+                printf("        Round Trip:       %lu us\n", atomic_load(&destination->reportRoundTripUSeconds));
+                printf("        Clock Offset:     %ld us\n", atomic_load(&destination->reportClockOffsetUSeconds));
+            }
+            printf("    Multicast TTL:        %u\n", sendParams->multicastTTL);
+            printf("    Multicast Interface:  %s\n", sendParams->multicastInterfaceIPAddress != NULL ? sendParams->multicastInterfaceIPAddress : "default");
+            printf("    Pace Percent:         %u\n", sendParams->pacePercent);
+            printf("    Pacer:                %s\n", sendParams->videoUDPSender->pacer == VIDEO_UDP_SENDER_PACER_KERNEL ? "kernel" : "user");
+            printf("    NACKs Received:       %lu\n", atomic_load(&sendParams->videoUDPSender->nackReceivedCount));
+            printf("    Packets Resent:       %lu\n", atomic_load(&sendParams->videoUDPSender->nackResentCount));
+            printf("    Report:               %s\n", sendParams->report ? "true" : "false");
+            printf("    Min Quality:          %u\n", sendParams->minQuality);
+            printf("    Quality:              %u (%s)\n", atomic_load(&sendParams->videoUDPSender->quality), sendParams->videoTranscoder != NULL ? "software" : "camera");
+            printf("    Reports Received:     %lu\n", atomic_load(&sendParams->videoUDPSender->reportReceivedCount));
+            printf("    Report Loss:          %lu per mille\n", atomic_load(&sendParams->videoUDPSender->reportLossPermille));
+            printf("    Report Late Frames:   %lu\n", atomic_load(&sendParams->videoUDPSender->reportLateCount));
+            printf("    Report Goodput:       %lu bytes/s\n", atomic_load(&sendParams->videoUDPSender->reportGoodput));
             break;
         case PARAM_TYPE_PIPE:
             PipeParams* pipeParams = params[paramIndex];
@@ -266,6 +427,36 @@ static inline void printParam(unsigned int paramIndex) {
             printf("    RGB or JPEG:          %s\n", pipeParams->rgbOrJPEG);
             printf("    Max Packet Length:    %u\n", pipeParams->maxPacketLength);
             break;
+        case PARAM_TYPE_STREAM_RECEIVE:
+            StreamReceiveParams* streamReceiveParams = params[paramIndex];
+            printf("Stream Receive:\n");
+            printf("    Local Address:        %s\n", streamReceiveParams->localAddressName);
+            printf("    Max JPEG Length:      %u\n", streamReceiveParams->maxJPEGLength);
+            printf("    Resolution Width:     %u\n", streamReceiveParams->resolutionWidth);
+            printf("    Resolution Height:    %u\n", streamReceiveParams->resolutionHeight);
+            printf("    Timebase Numerator:   %u\n", streamReceiveParams->timebaseNumerator);
+            printf("    Timebase Denominator: %u\n", streamReceiveParams->timebaseDenominator);
+            printf("    Connections:          %lu\n", streamReceiveParams->videoStreamReceiver->connectionCount);
+            printf("    Disconnections:       %lu\n", streamReceiveParams->videoStreamReceiver->disconnectionCount);
+            printf("    Frames Received:      %lu\n", streamReceiveParams->videoStreamReceiver->receivedFrameCount);
+            printf("    Bytes Received:       %lu\n", streamReceiveParams->videoStreamReceiver->receivedByteCount);
+            printf("    Invalid Frames:       %lu\n", streamReceiveParams->videoStreamReceiver->invalidFrameCount);
+            break;
+        case PARAM_TYPE_STREAM_SEND:
+            StreamSendParams* streamSendParams = params[paramIndex];
+            printf("Stream Send:\n");
+            printf("    Remote Address:       %s\n", streamSendParams->remoteAddressName);
+            printf("    Max JPEG Length:      %u\n", streamSendParams->maxJPEGLength);
+            printf("    Backlog:              %u\n", streamSendParams->backlogLength);
+            printf("    Not Sent Low Water:   %u\n", streamSendParams->notSentLowat);
+            printf("    Connections:          %lu\n", streamSendParams->videoStreamSender->connectionCount);
+            printf("    Disconnections:       %lu\n", streamSendParams->videoStreamSender->disconnectionCount);
+            printf("    Frames Sent:          %lu\n", streamSendParams->videoStreamSender->sentFrameCount);
+            printf("    Bytes Sent:           %lu\n", streamSendParams->videoStreamSender->sentByteCount);
+            printf("    Skipped Frames:       %lu\n", streamSendParams->videoStreamSender->skippedFrameCount);
+            printf("    Unconnected Frames:   %lu\n", streamSendParams->videoStreamSender->unconnectedFrameCount);
+            printf("    Queued Bytes:         %u\n", streamSendParams->videoStreamSender->queuedByteCount);
+            break;
         default:
             fprintf(stderr, "Unknown param type.\n");
             exit(EXIT_FAILURE);
@@ -279,6 +470,10 @@ static inline void printMetrics() {
         printf("Param %d:\n", paramIndex);
         printParam(paramIndex);
         printf("    Count:       %lu\n", paramMetrics->count);
+        if (paramIndex != 0) {
+            printf("    Queue:       %s %u\n", queuePolicyName(paramsQueuePolicies[paramIndex]), paramsQueueLengths[paramIndex]);
+            printf("    Dropped:     %lu\n", atomic_load(&paramsQueues[paramIndex]->droppedCount));
+        }
         if (paramIndex != 0) {
             printf("    Start:\n");
             printf("        Total:   %lu\n", paramMetrics->startTotal);
@@ -335,11 +530,31 @@ static inline void printUsage() {
     printf("        RESOLUTION_HEIGHT     (uint)    ie. 720\n");
     printf("        TIMEBASE_NUMERATOR    (uint)    ie. 1\n");
     printf("        TIMEBASE_DENOMINATOR  (uint)    ie. 30\n");
+    printf("        buffers=COUNT         (uint)    ie. 3 or auto (optional)\n");
+    printf("        latest=BOOL           (bool)    ie. true or false (optional)\n");
     printf("\n");
     printf("    receive\n");
     printf("        LOCAL_IP_ADDRESS      (string)  ie. 192.168.1.1\n");
     printf("        LOCAL_PORT            (uint)    ie. 8000\n");
-    printf("        MAX_PACKET_LENGTH     (uint)    ie. 1400\n");
+    printf("        MAX_PACKET_LENGTH     (uint)    ie. 1400 or auto\n");
+    printf("        MAX_JPEG_LENGTH       (uint)    ie. 1000000 or auto\n");
+    printf("        RESOLUTION_WIDTH      (uint)    ie. 1280 or auto\n");
+    printf("        RESOLUTION_HEIGHT     (uint)    ie. 720 or auto\n");
+    printf("        TIMEBASE_NUMERATOR    (uint)    ie. 1 or auto\n");
+    printf("        TIMEBASE_DENOMINATOR  (uint)    ie. 30 or auto\n");
+    printf("        gro=BOOL              (bool)    ie. true or false (optional)\n");
+    printf("        fec=PERCENT           (uint)    ie. 20 (optional)\n");
+    printf("        nack=DEADLINE_MS      (uint)    ie. 10 (optional)\n");
+    printf("        restart=DEADLINE_MS   (uint)    ie. 20 (optional)\n");
+    printf("        jitter=MAX_DELAY_MS   (uint)    ie. 100 (optional)\n");
+    printf("        interface=IP_ADDRESS  (string)  ie. 192.168.1.1 (optional)\n");
+    printf("        source=IP_ADDRESS     (string)  ie. 192.168.1.2 (optional)\n");
+    printf("        report=INTERVAL_MS    (uint)    ie. 250 (optional)\n");
+    printf("        stream=ID             (uint)    ie. 0 (optional)\n");
+    printf("        rtp=BOOL              (bool)    ie. true or false (optional)\n");
+    printf("\n");
+    printf("    stream-receive\n");
+    printf("        LOCAL_ADDRESS         (string)  ie. 192.168.1.1:8000 or unix:/tmp/video.sock\n");
     printf("        MAX_JPEG_LENGTH       (uint)    ie. 1000000\n");
     printf("        RESOLUTION_WIDTH      (uint)    ie. 1280\n");
     printf("        RESOLUTION_HEIGHT     (uint)    ie. 720\n");
@@ -362,11 +577,34 @@ static inline void printUsage() {
     printf("        MAX_PACKET_LENGTH     (uint)    ie. 1400\n");
     printf("        MAX_JPEG_LENGTH       (uint)    ie. 1000000\n");
     printf("        SEND_ROUNDS           (uint)    ie. 1\n");
+    printf("        zerocopy=BYTES        (uint)    ie. 100000 (optional)\n");
+    printf("        gso=BOOL              (bool)    ie. true or false (optional)\n");
+    printf("        fec=PERCENT           (uint)    ie. 20 (optional)\n");
+    printf("        nack=CACHE_FRAMES     (uint)    ie. 4 (optional)\n");
+    printf("        restart=BOOL          (bool)    ie. true or false (optional)\n");
+    printf("        ttl=HOPS              (uint)    ie. 1 (optional)\n");
+    printf("        interface=IP_ADDRESS  (string)  ie. 192.168.1.1 (optional)\n");
+    printf("        pace=PERCENT          (uint)    ie. 50 (optional)\n");
+    printf("        pacer=PACER           (string)  ie. kernel or user (optional)\n");
+    printf("        adapt=MIN_QUALITY     (uint)    ie. 30 (optional)\n");
+    printf("        report=BOOL           (bool)    ie. true or false (optional)\n");
+    printf("        stream=ID             (uint)    ie. 0 (optional)\n");
+    printf("        rtp=BOOL              (bool)    ie. true or false (optional)\n");
     printf("\n");
     printf("    pipe\n");
     printf("        PIPE_FILE_DESCRIPTOR  (int)     ie. 3\n");
     printf("        RGB_OR_JPEG           (string)  ie. rgb or jpeg\n");
     printf("        MAX_PACKET_LENGTH     (uint)    ie. 4096\n");
+    printf("\n");
+    printf("    stream-send\n");
+    printf("        REMOTE_ADDRESS        (string)  ie. 192.168.1.1:8000 or unix:/tmp/video.sock\n");
+    printf("        MAX_JPEG_LENGTH       (uint)    ie. 1000000\n");
+    printf("        backlog=BYTES         (uint)    ie. 0 (optional)\n");
+    printf("        lowat=BYTES           (uint)    ie. 16384 (optional)\n");
+    printf("\n");
+    printf("Output Options (optional, after any output):\n");
+    printf("        queue=POLICY          (string)  ie. block, drop-oldest or drop-newest\n");
+    printf("        queue-length=LENGTH   (uint)    ie. 2\n");
 }
 
 static inline void printDevices() {
@@ -439,8 +677,147 @@ static inline void printDevices() {
     closedir(dir);
 }
 
+static inline char* parseOption(int argc, char** argv, int* argn, char** optionValue) {
+    if (*argn >= argc) {
+        return NULL;
+    }
+    char* separator = strchr(argv[*argn], '=');
+    if (separator == NULL) {
+        return NULL;
+    }
+    *separator   = '\0';
+    *optionValue = separator + 1;
+    return argv[(*argn)++];
+}
+
+static inline bool parseBoolOption(char* optionValue) {
+    if (strcmp(optionValue, "true") == 0 || strcmp(optionValue, "1") == 0) {
+        return true;
+    }
+    if (strcmp(optionValue, "false") == 0 || strcmp(optionValue, "0") == 0) {
+        return false;
+    }
+    fprintf(stderr, "Expected true or false but got: %s.\n", optionValue);
+    exit(EXIT_FAILURE);
+}
+
+static inline bool parseQueueOption(char* optionKey, char* optionValue) {
+    if (strcmp(optionKey, "queue") == 0) {
+        if (strcmp(optionValue, "block") == 0) {
+            paramsQueuePolicies[paramsCount] = VIDEO_QUEUE_POLICY_BLOCK;
+        } else if (strcmp(optionValue, "drop-oldest") == 0) {
+            paramsQueuePolicies[paramsCount] = VIDEO_QUEUE_POLICY_DROP_OLDEST;
+        } else if (strcmp(optionValue, "drop-newest") == 0) {
+            paramsQueuePolicies[paramsCount] = VIDEO_QUEUE_POLICY_DROP_NEWEST;
+        } else {
+            fprintf(stderr, "Unknown queue policy: %s.\n", optionValue);
+            exit(EXIT_FAILURE);
+        }
+        return true;
+    }
+    if (strcmp(optionKey, "queue-length") == 0) {
+        paramsQueueLengths[paramsCount] = atoi(optionValue);
+        if (paramsQueueLengths[paramsCount] == 0) {
+            fprintf(stderr, "Queue length must be at least 1.\n");
+            exit(EXIT_FAILURE);
+        }
+        return true;
+    }
+    return false;
+}
+
+static inline unsigned int parseFECOption(char* optionValue) {
+    unsigned int fecPercent = atoi(optionValue);
+    if (fecPercent > MAX_FEC_PERCENT) {
+        fprintf(stderr, "FEC percent must be between 0 and %u.\n", MAX_FEC_PERCENT);
+        exit(EXIT_FAILURE);
+    }
+    return fecPercent;
+}
+
+static inline unsigned int parseAutoArgument(char* argument) {
+    return strcmp(argument, "auto") == 0 ? 0 : (unsigned int)atoi(argument);
+}
+
+static inline unsigned int parseStreamOption(char* optionValue) {
+    unsigned int streamId = atoi(optionValue);
+    if (streamId > MAX_STREAM_ID) {
+        fprintf(stderr, "Stream id must be between 0 and %u.\n", MAX_STREAM_ID);
+        exit(EXIT_FAILURE);
+    }
+    return streamId;
+}
+
+static inline struct in_addr parseMulticastAddress(char* ipAddress) {
+    struct in_addr address;
+    address.s_addr = htonl(INADDR_ANY);
+    if (ipAddress != NULL && inet_pton(AF_INET, ipAddress, &address) != 1) {
+        fprintf(stderr, "Invalid IP address: %s.\n", ipAddress);
+        exit(EXIT_FAILURE);
+    }
+    return address;
+}
+
+static inline struct sockaddr_in* parseRemoteAddresses(char* ipAddresses, unsigned int defaultPort, unsigned int* remoteAddressCount) {
+    *remoteAddressCount = 1;
+    for (char* separator = strchr(ipAddresses, ','); separator != NULL; separator = strchr(separator + 1, ',')) {
+        (*remoteAddressCount)++;
+    }
+    if (*remoteAddressCount > VIDEO_UDP_SENDER_MAX_DESTINATIONS) {
+        fprintf(stderr, "Too many remote addresses, at most %u are supported.\n", VIDEO_UDP_SENDER_MAX_DESTINATIONS);
+        exit(EXIT_FAILURE);
+    }
+    struct sockaddr_in* remoteAddresses = malloc(*remoteAddressCount * sizeof(struct sockaddr_in));
+    if (remoteAddresses == NULL) {
+        fprintf(stderr, "Unable to allocate memory for send remote addresses.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(remoteAddresses, 0, *remoteAddressCount * sizeof(struct sockaddr_in));
+    char* entry = ipAddresses;
+    for (unsigned int addressIndex = 0; addressIndex < *remoteAddressCount; addressIndex++) {
+        char   ipAddress[INET_ADDRSTRLEN];
+        char*  entryEnd    = strchr(entry, ',');
+        size_t entryLength = entryEnd != NULL ? (size_t)(entryEnd - entry) : strlen(entry);
+        char*  portStart   = memchr(entry, ':', entryLength);
+        size_t ipLength    = portStart != NULL ? (size_t)(portStart - entry) : entryLength;
+        if (ipLength >= INET_ADDRSTRLEN) {
+            fprintf(stderr, "Invalid remote address: %.*s.\n", (int)entryLength, entry);
+            exit(EXIT_FAILURE);
+        }
+        memcpy(ipAddress, entry, ipLength);
+        ipAddress[ipLength]                      = '\0';
+        remoteAddresses[addressIndex].sin_family = AF_INET;
+        remoteAddresses[addressIndex].sin_port   = htons(portStart != NULL ? (unsigned int)atoi(portStart + 1) : defaultPort);
+        if (inet_pton(AF_INET, ipAddress, &remoteAddresses[addressIndex].sin_addr) != 1) {
+            fprintf(stderr, "Invalid remote address: %.*s.\n", (int)entryLength, entry);
+            exit(EXIT_FAILURE);
+        }
+        entry = entryEnd != NULL ? entryEnd + 1 : entry + entryLength;
+    }
+    return remoteAddresses;
+}
+
+static inline void setOutputDefaults(unsigned int defaultQueuePolicy) {
+    paramsQueuePolicies[paramsCount] = defaultQueuePolicy;
+    paramsQueueLengths[paramsCount]  = VIDEO_QUEUE_DEFAULT_LENGTH;
+}
+
+static inline void parseOutputOptions(int argc, char** argv, int* argn, unsigned int defaultQueuePolicy) {
+    char* optionKey;
+    char* optionValue;
+    setOutputDefaults(defaultQueuePolicy);
+    while ((optionKey = parseOption(argc, argv, argn, &optionValue)) != NULL) {
+        if (!parseQueueOption(optionKey, optionValue)) {
+            fprintf(stderr, "Unknown option: %s.\n", optionKey);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
 static inline void parseParams(int argc, char** argv) {
-    int argn = 1;
+    int   argn = 1;
+    char* optionKey;
+    char* optionValue;
     for (;;) {
         if (argn >= argc) {
             break;
@@ -468,8 +845,23 @@ static inline void parseParams(int argc, char** argv) {
             sourceTimebaseNumerator            = captureParams->timebaseNumerator;
             captureParams->timebaseDenominator = atoi(argv[argn + 5]);
             sourceTimebaseDenominator          = captureParams->timebaseDenominator;
+            captureParams->bufferCount         = VIDEO_CAPTURE_DEFAULT_BUFFER_COUNT;
             argn += 6;
-            captureParams->videoCapture = VideoCaptureCreate(captureParams->deviceName, captureParams->resolutionWidth, captureParams->resolutionHeight, captureParams->timebaseNumerator, captureParams->timebaseDenominator);
+            while ((optionKey = parseOption(argc, argv, &argn, &optionValue)) != NULL) {
+                if (strcmp(optionKey, "buffers") == 0) {
+                    captureParams->bufferCount = strcmp(optionValue, "auto") == 0 ? VIDEO_CAPTURE_AUTO_BUFFER_COUNT : (unsigned int)atoi(optionValue);
+                    if (captureParams->bufferCount != VIDEO_CAPTURE_AUTO_BUFFER_COUNT && (captureParams->bufferCount < VIDEO_CAPTURE_MIN_BUFFER_COUNT || captureParams->bufferCount > VIDEO_CAPTURE_MAX_BUFFER_COUNT)) {
+                        fprintf(stderr, "Buffer count must be auto or between %u and %u.\n", VIDEO_CAPTURE_MIN_BUFFER_COUNT, VIDEO_CAPTURE_MAX_BUFFER_COUNT);
+                        exit(EXIT_FAILURE);
+                    }
+                } else if (strcmp(optionKey, "latest") == 0) {
+                    captureParams->latest = parseBoolOption(optionValue);
+                } else {
+                    fprintf(stderr, "Unknown option: %s.\n", optionKey);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            captureParams->videoCapture = VideoCaptureCreate(captureParams->deviceName, captureParams->resolutionWidth, captureParams->resolutionHeight, captureParams->timebaseNumerator, captureParams->timebaseDenominator, captureParams->bufferCount, captureParams->latest);
             renderWindowTitle           = malloc(MAX_WINDOW_TITLE_LENGTH);
             if (renderWindowTitle == NULL) {
                 fprintf(stderr, "Unable to allocate memory for render window title.\n");
@@ -502,32 +894,61 @@ static inline void parseParams(int argc, char** argv) {
             receiveParams->localAddress->sin_family      = AF_INET;
             receiveParams->localAddress->sin_addr.s_addr = inet_addr(receiveParams->localIPAddress);
             receiveParams->localAddress->sin_port        = htons(receiveParams->localPort);
-            receiveParams->maxPacketLength               = atoi(argv[argn + 3]);
-            receiveParams->maxJPEGLength                 = atoi(argv[argn + 4]);
-            receiveParams->resolutionWidth               = atoi(argv[argn + 5]);
-            sourceWidth                                  = receiveParams->resolutionWidth;
-            receiveParams->resolutionHeight              = atoi(argv[argn + 6]);
-            sourceHeight                                 = receiveParams->resolutionHeight;
-            receiveParams->timebaseNumerator             = atoi(argv[argn + 7]);
-            sourceTimebaseNumerator                      = receiveParams->timebaseNumerator;
-            receiveParams->timebaseDenominator           = atoi(argv[argn + 8]);
-            sourceTimebaseDenominator                    = receiveParams->timebaseDenominator;
-            receiveParams->jpegBuffer                    = malloc(receiveParams->maxJPEGLength);
-            if (receiveParams->jpegBuffer == NULL) {
-                fprintf(stderr, "Unable to allocate memory for receive jpeg buffer.\n");
-                exit(EXIT_FAILURE);
+            receiveParams->maxPacketLength               = parseAutoArgument(argv[argn + 3]);
+            receiveParams->maxJPEGLength                 = parseAutoArgument(argv[argn + 4]);
+            receiveParams->resolutionWidth               = parseAutoArgument(argv[argn + 5]);
+            receiveParams->resolutionHeight              = parseAutoArgument(argv[argn + 6]);
+            receiveParams->timebaseNumerator             = parseAutoArgument(argv[argn + 7]);
+            receiveParams->timebaseDenominator           = parseAutoArgument(argv[argn + 8]);
+            argn += 9;
+            while ((optionKey = parseOption(argc, argv, &argn, &optionValue)) != NULL) {
+                if (strcmp(optionKey, "gro") == 0) {
+                    receiveParams->gro = parseBoolOption(optionValue);
+                } else if (strcmp(optionKey, "fec") == 0) {
+                    receiveParams->fecPercent = parseFECOption(optionValue);
+                } else if (strcmp(optionKey, "nack") == 0) {
+                    receiveParams->nackDeadlineMSeconds = atoi(optionValue);
+                } else if (strcmp(optionKey, "restart") == 0) {
+                    receiveParams->restartDeadlineMSeconds = atoi(optionValue);
+                } else if (strcmp(optionKey, "jitter") == 0) {
+                    receiveParams->jitterMaxDelayMSeconds = atoi(optionValue);
+                } else if (strcmp(optionKey, "interface") == 0) {
+                    receiveParams->multicastInterfaceIPAddress = optionValue;
+                } else if (strcmp(optionKey, "source") == 0) {
+                    receiveParams->multicastSourceIPAddress = optionValue;
+                } else if (strcmp(optionKey, "report") == 0) {
+                    receiveParams->reportIntervalMSeconds = atoi(optionValue);
+                } else if (strcmp(optionKey, "stream") == 0) {
+                    receiveParams->streamId = parseStreamOption(optionValue);
+                } else if (strcmp(optionKey, "rtp") == 0) {
+                    receiveParams->rtp = parseBoolOption(optionValue);
+                } else {
+                    fprintf(stderr, "Unknown option: %s.\n", optionKey);
+                    exit(EXIT_FAILURE);
+                }
             }
-            memset(receiveParams->jpegBuffer, 0, receiveParams->maxJPEGLength);
-            receiveParams->jpegBufferLength = 0;
-            renderWindowTitle               = malloc(MAX_WINDOW_TITLE_LENGTH);
+            receiveParams->videoUDPReceiver    = VideoUDPReceiverCreate(receiveParams->maxPacketLength, receiveParams->maxJPEGLength, receiveParams->resolutionWidth, receiveParams->resolutionHeight, receiveParams->timebaseNumerator, receiveParams->timebaseDenominator, receiveParams->localAddress, receiveParams->gro, receiveParams->fecPercent, receiveParams->nackDeadlineMSeconds, receiveParams->restartDeadlineMSeconds, parseMulticastAddress(receiveParams->multicastInterfaceIPAddress), parseMulticastAddress(receiveParams->multicastSourceIPAddress), receiveParams->reportIntervalMSeconds, receiveParams->streamId, receiveParams->rtp);
+            receiveParams->maxPacketLength     = receiveParams->videoUDPReceiver->maxPacketLength;
+            receiveParams->maxJPEGLength       = receiveParams->videoUDPReceiver->maxJPEGLength;
+            receiveParams->resolutionWidth     = receiveParams->videoUDPReceiver->width;
+            sourceWidth                        = receiveParams->resolutionWidth;
+            receiveParams->resolutionHeight    = receiveParams->videoUDPReceiver->height;
+            sourceHeight                       = receiveParams->resolutionHeight;
+            receiveParams->timebaseNumerator   = receiveParams->videoUDPReceiver->timebaseNumerator;
+            sourceTimebaseNumerator            = receiveParams->timebaseNumerator;
+            receiveParams->timebaseDenominator = receiveParams->videoUDPReceiver->timebaseDenominator;
+            sourceTimebaseDenominator          = receiveParams->timebaseDenominator;
+            receiveParams->fecPercent          = receiveParams->videoUDPReceiver->fecPercent;
+            renderWindowTitle                  = malloc(MAX_WINDOW_TITLE_LENGTH);
             if (renderWindowTitle == NULL) {
                 fprintf(stderr, "Unable to allocate memory for render window title.\n");
                 exit(EXIT_FAILURE);
             }
             memset(renderWindowTitle, 0, MAX_WINDOW_TITLE_LENGTH);
             snprintf(renderWindowTitle, MAX_WINDOW_TITLE_LENGTH, "%s:%u %ux%u %u/%u", receiveParams->localIPAddress, receiveParams->localPort, receiveParams->resolutionWidth, receiveParams->resolutionHeight, receiveParams->timebaseNumerator, receiveParams->timebaseDenominator);
-            argn += 9;
-            receiveParams->videoUDPReceiver = VideoUDPReceiverCreate(receiveParams->maxPacketLength, receiveParams->maxJPEGLength, receiveParams->localAddress);
+            if (receiveParams->jitterMaxDelayMSeconds > 0) {
+                receiveParams->videoJitterBuffer = VideoJitterBufferCreate(receiveParams->jitterMaxDelayMSeconds, receiveParams->timebaseNumerator, receiveParams->timebaseDenominator);
+            }
             params[paramsCount]             = receiveParams;
             paramsTypes[paramsCount]        = PARAM_TYPE_RECEIVE;
             paramsCount++;
@@ -545,9 +966,12 @@ static inline void parseParams(int argc, char** argv) {
             renderParams->windowWidth  = atoi(argv[argn + 1]);
             renderParams->windowHeight = atoi(argv[argn + 2]);
             argn += 3;
+            parseOutputOptions(argc, argv, &argn, VIDEO_QUEUE_POLICY_DROP_OLDEST);
             renderParams->videoRenderer = VideoRendererCreate(sourceWidth, sourceHeight, renderParams->windowWidth, renderParams->windowHeight, renderWindowTitle);
-            params[paramsCount]         = renderParams;
-            paramsTypes[paramsCount]    = PARAM_TYPE_RENDER;
+            renderParams->videoDecoder  = VideoDecoderCreate(sourceWidth, sourceHeight);
+            VideoRendererDetachThread(renderParams->videoRenderer);
+            params[paramsCount]      = renderParams;
+            paramsTypes[paramsCount] = PARAM_TYPE_RENDER;
             paramsCount++;
         } else if (strcmp(argv[argn], "record") == 0) {
             if (argc < argn + 2) {
@@ -562,6 +986,7 @@ static inline void parseParams(int argc, char** argv) {
             memset(recordParams, 0, sizeof(RecordParams));
             recordParams->fileName = argv[argn + 1];
             argn += 2;
+            parseOutputOptions(argc, argv, &argn, VIDEO_QUEUE_POLICY_BLOCK);
             recordParams->videoRecorder = VideoRecorderCreate(recordParams->fileName, sourceWidth, sourceHeight, sourceTimebaseNumerator, sourceTimebaseDenominator);
             params[paramsCount]         = recordParams;
             paramsTypes[paramsCount]    = PARAM_TYPE_RECORD;
@@ -590,25 +1015,79 @@ static inline void parseParams(int argc, char** argv) {
             sendParams->localAddress->sin_port        = htons(sendParams->localPort);
             sendParams->remoteIPAddress               = argv[argn + 3];
             sendParams->remotePort                    = atoi(argv[argn + 4]);
-            sendParams->remoteAddress                 = malloc(sizeof(struct sockaddr_in));
-            if (sendParams->remoteAddress == NULL) {
-                fprintf(stderr, "Unable to allocate memory for send remote address.\n");
-                exit(EXIT_FAILURE);
-            }
-            memset(sendParams->remoteAddress, 0, sizeof(struct sockaddr_in));
-            sendParams->remoteAddress->sin_family      = AF_INET;
-            sendParams->remoteAddress->sin_addr.s_addr = inet_addr(sendParams->remoteIPAddress);
-            sendParams->remoteAddress->sin_port        = htons(sendParams->remotePort);
+            sendParams->remoteAddresses               = parseRemoteAddresses(sendParams->remoteIPAddress, sendParams->remotePort, &sendParams->remoteAddressCount);
             sendParams->maxPacketLength                = atoi(argv[argn + 5]);
             sendParams->maxJPEGLength                  = atoi(argv[argn + 6]);
             sendParams->sendRounds                     = atoi(argv[argn + 7]);
             argn += 8;
-            sendParams->videoUDPSender = VideoUDPSenderCreate(sendParams->maxPacketLength, sendParams->maxJPEGLength, sendParams->localAddress, sendParams->remoteAddress);
-            params[paramsCount]        = sendParams;
-            paramsTypes[paramsCount]   = PARAM_TYPE_SEND;
+            setOutputDefaults(VIDEO_QUEUE_POLICY_DROP_OLDEST);
+            while ((optionKey = parseOption(argc, argv, &argn, &optionValue)) != NULL) {
+                if (parseQueueOption(optionKey, optionValue)) {
+                    continue;
+                }
+                if (strcmp(optionKey, "zerocopy") == 0) {
+                    sendParams->zeroCopyThreshold = atoi(optionValue);
+                } else if (strcmp(optionKey, "gso") == 0) {
+                    sendParams->gso = parseBoolOption(optionValue);
+                } else if (strcmp(optionKey, "fec") == 0) {
+                    sendParams->fecPercent = parseFECOption(optionValue);
+                } else if (strcmp(optionKey, "nack") == 0) {
+                    sendParams->nackCacheLength = atoi(optionValue);
+                } else if (strcmp(optionKey, "restart") == 0) {
+                    sendParams->restart = parseBoolOption(optionValue);
+                } else if (strcmp(optionKey, "ttl") == 0) {
+                    sendParams->multicastTTL = atoi(optionValue);
+                    if (sendParams->multicastTTL > 255) {
+                        fprintf(stderr, "Multicast TTL must be between 0 and 255.\n");
+                        exit(EXIT_FAILURE);
+                    }
+                } else if (strcmp(optionKey, "interface") == 0) {
+                    sendParams->multicastInterfaceIPAddress = optionValue;
+                } else if (strcmp(optionKey, "pace") == 0) {
+                    sendParams->pacePercent = atoi(optionValue);
+                    if (sendParams->pacePercent > 100) {
+                        fprintf(stderr, "Pace percent must be between 0 and 100.\n");
+                        exit(EXIT_FAILURE);
+                    }
+                } else if (strcmp(optionKey, "pacer") == 0) {
+                    if (strcmp(optionValue, "kernel") == 0) {
+                        sendParams->pacer = VIDEO_UDP_SENDER_PACER_KERNEL;
+                    } else if (strcmp(optionValue, "user") == 0) {
+                        sendParams->pacer = VIDEO_UDP_SENDER_PACER_USER;
+                    } else {
+                        fprintf(stderr, "Unknown pacer: %s.\n", optionValue);
+                        exit(EXIT_FAILURE);
+                    }
+                } else if (strcmp(optionKey, "report") == 0) {
+                    sendParams->report = parseBoolOption(optionValue);
+                } else if (strcmp(optionKey, "stream") == 0) {
+                    sendParams->streamId = parseStreamOption(optionValue);
+                } else if (strcmp(optionKey, "rtp") == 0) {
+                    sendParams->rtp = parseBoolOption(optionValue);
+                } else if (strcmp(optionKey, "adapt") == 0) {
+                    sendParams->minQuality = atoi(optionValue);
+                    if (sendParams->minQuality == 0 || sendParams->minQuality > VIDEO_UDP_SENDER_MAX_QUALITY) {
+                        fprintf(stderr, "Adaptive minimum quality must be between 1 and %u.\n", VIDEO_UDP_SENDER_MAX_QUALITY);
+                        exit(EXIT_FAILURE);
+                    }
+                } else {
+                    fprintf(stderr, "Unknown option: %s.\n", optionKey);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (sendParams->pacePercent > 0 && sourceTimebaseDenominator == 0) {
+                fprintf(stderr, "Pacing needs a timebase from the input.\n");
+                exit(EXIT_FAILURE);
+            }
+            sendParams->videoUDPSender = VideoUDPSenderCreate(sendParams->maxPacketLength, sendParams->maxJPEGLength, sendParams->localAddress, sendParams->remoteAddresses, sendParams->remoteAddressCount, sendParams->zeroCopyThreshold, sendParams->gso, sendParams->fecPercent, sendParams->nackCacheLength, sendParams->restart, sendParams->multicastTTL, parseMulticastAddress(sendParams->multicastInterfaceIPAddress), sendParams->pacePercent, sendParams->pacer, sourceWidth, sourceHeight, sourceTimebaseNumerator, sourceTimebaseDenominator, sendParams->minQuality, sendParams->report, sendParams->streamId, sendParams->rtp);
+            if (sendParams->minQuality > 0 && !(paramsTypes[0] == PARAM_TYPE_CAPTURE && ((CaptureParams*)params[0])->videoCapture->qualityControl)) {
+                sendParams->videoTranscoder = VideoTranscoderCreate(sourceWidth, sourceHeight);
+            }
+            params[paramsCount]            = sendParams;
+            paramsTypes[paramsCount]       = PARAM_TYPE_SEND;
             paramsCount++;
         } else if (strcmp(argv[argn], "pipe") == 0) {
-            if (argc < argn + 3) {
+            if (argc < argn + 4) {
                 fprintf(stderr, "Not enough arguments.\n");
                 exit(EXIT_FAILURE);
             }
@@ -621,11 +1100,92 @@ static inline void parseParams(int argc, char** argv) {
             pipeParams->pipeFileDescriptor = atoi(argv[argn + 1]);
             pipeParams->rgbOrJPEG          = argv[argn + 2];
             pipeParams->rgb                = strcmp(pipeParams->rgbOrJPEG, "rgb") == 0;
-            argn += 3;
-            pipeParams->videoPipe    = VideoPipeCreate(pipeParams->pipeFileDescriptor, pipeParams->maxPacketLength);
+            pipeParams->maxPacketLength    = atoi(argv[argn + 3]);
+            argn += 4;
+            parseOutputOptions(argc, argv, &argn, VIDEO_QUEUE_POLICY_BLOCK);
+            pipeParams->videoPipe = VideoPipeCreate(pipeParams->pipeFileDescriptor, pipeParams->maxPacketLength);
+            if (pipeParams->rgb) {
+                pipeParams->videoDecoder = VideoDecoderCreate(sourceWidth, sourceHeight);
+            }
             params[paramsCount]      = pipeParams;
             paramsTypes[paramsCount] = PARAM_TYPE_PIPE;
             paramsCount++;
+        } else if (strcmp(argv[argn], "stream-receive") == 0) {
+            if (argc < argn + 7) {
+                fprintf(stderr, "Not enough arguments.\n");
+                exit(EXIT_FAILURE);
+            }
+            StreamReceiveParams* streamReceiveParams = malloc(sizeof(StreamReceiveParams));
+            if (streamReceiveParams == NULL) {
+                fprintf(stderr, "Unable to allocate memory for stream receive params.\n");
+                exit(EXIT_FAILURE);
+            }
+            memset(streamReceiveParams, 0, sizeof(StreamReceiveParams));
+            streamReceiveParams->localAddressName    = argv[argn + 1];
+            streamReceiveParams->localAddressLength  = VideoStreamSharedParseAddress(streamReceiveParams->localAddressName, &streamReceiveParams->localAddress);
+            streamReceiveParams->maxJPEGLength       = atoi(argv[argn + 2]);
+            streamReceiveParams->resolutionWidth     = atoi(argv[argn + 3]);
+            sourceWidth                              = streamReceiveParams->resolutionWidth;
+            streamReceiveParams->resolutionHeight    = atoi(argv[argn + 4]);
+            sourceHeight                             = streamReceiveParams->resolutionHeight;
+            streamReceiveParams->timebaseNumerator   = atoi(argv[argn + 5]);
+            sourceTimebaseNumerator                  = streamReceiveParams->timebaseNumerator;
+            streamReceiveParams->timebaseDenominator = atoi(argv[argn + 6]);
+            sourceTimebaseDenominator                = streamReceiveParams->timebaseDenominator;
+            argn += 7;
+            while ((optionKey = parseOption(argc, argv, &argn, &optionValue)) != NULL) {
+                fprintf(stderr, "Unknown option: %s.\n", optionKey);
+                exit(EXIT_FAILURE);
+            }
+            if (streamReceiveParams->maxJPEGLength == 0) {
+                fprintf(stderr, "Max JPEG length must be greater than 0.\n");
+                exit(EXIT_FAILURE);
+            }
+            streamReceiveParams->videoStreamReceiver = VideoStreamReceiverCreate(&streamReceiveParams->localAddress, streamReceiveParams->localAddressLength, streamReceiveParams->maxJPEGLength);
+            renderWindowTitle                        = malloc(MAX_WINDOW_TITLE_LENGTH);
+            if (renderWindowTitle == NULL) {
+                fprintf(stderr, "Unable to allocate memory for render window title.\n");
+                exit(EXIT_FAILURE);
+            }
+            memset(renderWindowTitle, 0, MAX_WINDOW_TITLE_LENGTH);
+            snprintf(renderWindowTitle, MAX_WINDOW_TITLE_LENGTH, "%s %ux%u %u/%u", streamReceiveParams->localAddressName, streamReceiveParams->resolutionWidth, streamReceiveParams->resolutionHeight, streamReceiveParams->timebaseNumerator, streamReceiveParams->timebaseDenominator);
+            params[paramsCount]      = streamReceiveParams;
+            paramsTypes[paramsCount] = PARAM_TYPE_STREAM_RECEIVE;
+            paramsCount++;
+        } else if (strcmp(argv[argn], "stream-send") == 0) {
+            if (argc < argn + 3) {
+                fprintf(stderr, "Not enough arguments.\n");
+                exit(EXIT_FAILURE);
+            }
+            StreamSendParams* streamSendParams = malloc(sizeof(StreamSendParams));
+            if (streamSendParams == NULL) {
+                fprintf(stderr, "Unable to allocate memory for stream send params.\n");
+                exit(EXIT_FAILURE);
+            }
+            memset(streamSendParams, 0, sizeof(StreamSendParams));
+            streamSendParams->remoteAddressName   = argv[argn + 1];
+            streamSendParams->remoteAddressLength = VideoStreamSharedParseAddress(streamSendParams->remoteAddressName, &streamSendParams->remoteAddress);
+            streamSendParams->maxJPEGLength       = atoi(argv[argn + 2]);
+            streamSendParams->notSentLowat        = VIDEO_STREAM_SENDER_DEFAULT_NOTSENT_LOWAT;
+            argn += 3;
+            setOutputDefaults(VIDEO_QUEUE_POLICY_DROP_OLDEST);
+            while ((optionKey = parseOption(argc, argv, &argn, &optionValue)) != NULL) {
+                if (parseQueueOption(optionKey, optionValue)) {
+                    continue;
+                }
+                if (strcmp(optionKey, "backlog") == 0) {
+                    streamSendParams->backlogLength = atoi(optionValue);
+                } else if (strcmp(optionKey, "lowat") == 0) {
+                    streamSendParams->notSentLowat = atoi(optionValue);
+                } else {
+                    fprintf(stderr, "Unknown option: %s.\n", optionKey);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            streamSendParams->videoStreamSender = VideoStreamSenderCreate(&streamSendParams->remoteAddress, streamSendParams->remoteAddressLength, streamSendParams->maxJPEGLength, streamSendParams->backlogLength, streamSendParams->notSentLowat);
+            params[paramsCount]                 = streamSendParams;
+            paramsTypes[paramsCount]            = PARAM_TYPE_STREAM_SEND;
+            paramsCount++;
         } else {
             fprintf(stderr, "Unexpected argument at %d: %s.\n", argn, argv[argn]);
             exit(EXIT_FAILURE);
@@ -638,13 +1198,13 @@ static inline void validateParams() {
         fprintf(stderr, "Not enough params.\n");
         exit(EXIT_FAILURE);
     }
-    if (paramsTypes[0] != PARAM_TYPE_CAPTURE && paramsTypes[0] != PARAM_TYPE_RECEIVE) {
-        fprintf(stderr, "First param must be capture or receive.\n");
+    if (paramsTypes[0] != PARAM_TYPE_CAPTURE && paramsTypes[0] != PARAM_TYPE_RECEIVE && paramsTypes[0] != PARAM_TYPE_STREAM_RECEIVE) {
+        fprintf(stderr, "First param must be capture, receive or stream-receive.\n");
         exit(EXIT_FAILURE);
     }
     for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
-        if (paramsTypes[paramIndex] == PARAM_TYPE_CAPTURE || paramsTypes[paramIndex] == PARAM_TYPE_RECEIVE) {
-            fprintf(stderr, "Capture or receive must be the first param only.\n");
+        if (paramsTypes[paramIndex] == PARAM_TYPE_CAPTURE || paramsTypes[paramIndex] == PARAM_TYPE_RECEIVE || paramsTypes[paramIndex] == PARAM_TYPE_STREAM_RECEIVE) {
+            fprintf(stderr, "Capture, receive or stream-receive must be the first param only.\n");
             exit(EXIT_FAILURE);
         }
     }
@@ -660,18 +1220,212 @@ static inline void validateParams() {
     }
 }
 
-static inline void createVideoDecoderIfRequired() {
-    bool found = false;
-    for (unsigned int paramIndex = 0; paramIndex < paramsCount; paramIndex++) {
-        if (paramsTypes[paramIndex] == PARAM_TYPE_RENDER || (paramsTypes[paramIndex] == PARAM_TYPE_PIPE && ((PipeParams*)params[paramIndex])->rgb)) {
-            found = true;
+static inline void createVideoFramePoolIfRequired() {
+    if (paramsTypes[0] == PARAM_TYPE_STREAM_RECEIVE) {
+        StreamReceiveParams* streamReceiveParams = params[0];
+        unsigned int         frameCount          = 1;
+        for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+            frameCount += paramsQueueLengths[paramIndex] + 1;
+        }
+        videoFramePool = VideoFramePoolCreate(frameCount, streamReceiveParams->maxJPEGLength);
+        return;
+    }
+    if (paramsTypes[0] != PARAM_TYPE_RECEIVE) {
+        return;
+    }
+    ReceiveParams* receiveParams = params[0];
+    unsigned int   frameCount    = VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT + 1;
+    if (receiveParams->videoJitterBuffer != NULL) {
+        frameCount += receiveParams->videoJitterBuffer->capacity;
+    }
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        frameCount += paramsQueueLengths[paramIndex] + 1;
+    }
+    videoFramePool = VideoFramePoolCreate(frameCount, receiveParams->videoUDPReceiver->frameBufferCapacity);
+}
+
+static inline VideoFrame* getFrame() {
+    switch (paramsTypes[0]) {
+        case PARAM_TYPE_CAPTURE: {
+            CaptureParams* captureParams = params[0];
+            return VideoCaptureGetFrame(captureParams->videoCapture);
+        }
+        case PARAM_TYPE_RECEIVE: {
+            ReceiveParams* receiveParams = params[0];
+            return VideoUDPReceiverReceiveFrame(receiveParams->videoUDPReceiver, videoFramePool);
+        }
+        case PARAM_TYPE_STREAM_RECEIVE: {
+            StreamReceiveParams* streamReceiveParams = params[0];
+            return VideoStreamReceiverReceiveFrame(streamReceiveParams->videoStreamReceiver, videoFramePool);
+        }
+        default:
+            return NULL;
+    }
+}
+
+static inline VideoJitterBuffer* getJitterBuffer() {
+    if (paramsTypes[0] != PARAM_TYPE_RECEIVE) {
+        return NULL;
+    }
+    ReceiveParams* receiveParams = params[0];
+    return receiveParams->videoJitterBuffer;
+}
+
+static inline void dispatchFrame(VideoFrame* videoFrame) {
+    VideoFrameRetain(videoFrame, paramsCount - 1);
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        VideoFrame* droppedFrame = VideoQueuePush(paramsQueues[paramIndex], videoFrame);
+        if (droppedFrame != NULL) {
+            VideoFrameRelease(droppedFrame);
+        }
+    }
+    VideoFrameRelease(videoFrame);
+}
+
+static inline void scheduleFrame(VideoFrame* videoFrame) {
+    VideoJitterBuffer* videoJitterBuffer = getJitterBuffer();
+    if (videoJitterBuffer == NULL) {
+        dispatchFrame(videoFrame);
+        return;
+    }
+    VideoFrame* droppedFrame = VideoJitterBufferPush(videoJitterBuffer, videoFrame);
+    if (droppedFrame != NULL) {
+        VideoFrameRelease(droppedFrame);
+    }
+}
+
+static void* playoutLoop(void* argument) {
+    VideoJitterBuffer* videoJitterBuffer = argument;
+    VideoFrame*        videoFrame;
+    while ((videoFrame = VideoJitterBufferPop(videoJitterBuffer)) != NULL) {
+        dispatchFrame(videoFrame);
+    }
+    return NULL;
+}
+
+static inline void outputFrame(unsigned int paramIndex, VideoFrame* videoFrame) {
+    switch (paramsTypes[paramIndex]) {
+        case PARAM_TYPE_RENDER: {
+            RenderParams* renderParams = params[paramIndex];
+            VideoDecoderDecodeFrame(renderParams->videoDecoder, videoFrame->jpegBuffer, videoFrame->jpegBufferLength);
+            VideoRendererRender(renderParams->videoRenderer, renderParams->videoDecoder->rgbBuffer);
+            break;
+        }
+        case PARAM_TYPE_RECORD: {
+            RecordParams* recordParams = params[paramIndex];
+            VideoRecorderRecordFrame(recordParams->videoRecorder, videoFrame->uTimestamp, videoFrame->jpegBuffer, videoFrame->jpegBufferLength);
+            break;
+        }
+        case PARAM_TYPE_SEND: {
+            SendParams*  sendParams = params[paramIndex];
+            void*        jpeg       = videoFrame->jpegBuffer;
+            unsigned int jpegLength = videoFrame->jpegBufferLength;
+            if (sendParams->videoTranscoder != NULL) {
+                unsigned int quality = atomic_load(&sendParams->videoUDPSender->quality);
+                if (quality < VIDEO_UDP_SENDER_MAX_QUALITY && VideoTranscoderTranscodeFrame(sendParams->videoTranscoder, jpeg, jpegLength, quality) && sendParams->videoTranscoder->jpegBufferLength < jpegLength) {
+                    jpeg       = sendParams->videoTranscoder->jpegBuffer;
+                    jpegLength = sendParams->videoTranscoder->jpegBufferLength;
+                }
+            }
+            VideoUDPSenderSendFrame(sendParams->videoUDPSender, videoFrame->uTimestamp, jpeg, jpegLength, sendParams->sendRounds);
+            break;
+        }
+        case PARAM_TYPE_PIPE: {
+            PipeParams* pipeParams = params[paramIndex];
+            if (pipeParams->rgb) {
+                VideoDecoderDecodeFrame(pipeParams->videoDecoder, videoFrame->jpegBuffer, videoFrame->jpegBufferLength);
+                VideoPipeWriteFrame(pipeParams->videoPipe, videoFrame->uTimestamp, pipeParams->videoDecoder->rgbBuffer, pipeParams->videoDecoder->rgbBufferLength);
+            } else {
+                VideoPipeWriteFrame(pipeParams->videoPipe, videoFrame->uTimestamp, videoFrame->jpegBuffer, videoFrame->jpegBufferLength);
+            }
+            break;
+        }
+        case PARAM_TYPE_STREAM_SEND: {
+            StreamSendParams* streamSendParams = params[paramIndex];
+            VideoStreamSenderSendFrame(streamSendParams->videoStreamSender, videoFrame->uTimestamp, videoFrame->jpegBuffer, videoFrame->jpegBufferLength);
             break;
         }
     }
-    if (!found) {
+}
+
+static void* outputLoop(void* argument) {
+    unsigned int paramIndex = (unsigned int)(uintptr_t)argument;
+    if (paramsTypes[paramIndex] == PARAM_TYPE_RENDER) {
+        VideoRendererAttachThread(((RenderParams*)params[paramIndex])->videoRenderer);
+    }
+    VideoFrame* videoFrame;
+    while ((videoFrame = VideoQueuePop(paramsQueues[paramIndex])) != NULL) {
+#ifdef MEASURE
+        paramsMetricsStart(paramIndex, videoFrame->uTimestamp);
+#endif
+        outputFrame(paramIndex, videoFrame);
+#ifdef MEASURE
+        paramsMetricsEnd(paramIndex, videoFrame->uTimestamp);
+#endif
+        VideoFrameRelease(videoFrame);
+    }
+    if (paramsTypes[paramIndex] == PARAM_TYPE_RENDER) {
+        VideoRendererDetachThread(((RenderParams*)params[paramIndex])->videoRenderer);
+    }
+    return NULL;
+}
+
+static inline void startOutputs() {
+    sigset_t signalSet;
+    sigset_t previousSignalSet;
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &signalSet, &previousSignalSet);
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        paramsQueues[paramIndex] = VideoQueueCreate(paramsQueueLengths[paramIndex], paramsQueuePolicies[paramIndex]);
+        if (pthread_create(&paramsThreads[paramIndex], NULL, outputLoop, (void*)(uintptr_t)paramIndex) != 0) {
+            fprintf(stderr, "Unable to create output thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    VideoJitterBuffer* videoJitterBuffer = getJitterBuffer();
+    if (videoJitterBuffer != NULL && pthread_create(&playoutThread, NULL, playoutLoop, videoJitterBuffer) != 0) {
+        fprintf(stderr, "Unable to create playout thread.\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignalSet, NULL);
+}
+
+static inline void stopOutputs() {
+    VideoJitterBuffer* videoJitterBuffer = getJitterBuffer();
+    if (videoJitterBuffer != NULL) {
+        VideoJitterBufferClose(videoJitterBuffer);
+        pthread_join(playoutThread, NULL);
+    }
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        VideoQueueClose(paramsQueues[paramIndex]);
+    }
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        pthread_join(paramsThreads[paramIndex], NULL);
+    }
+}
+
+static inline void adaptCaptureQuality() {
+    if (paramsTypes[0] != PARAM_TYPE_CAPTURE) {
+        return;
+    }
+    CaptureParams* captureParams = params[0];
+    if (!captureParams->videoCapture->qualityControl) {
         return;
     }
-    videoDecoder = VideoDecoderCreate(sourceWidth, sourceHeight);
+    unsigned int quality  = VIDEO_CAPTURE_MAX_QUALITY;
+    bool         adaptive = false;
+    for (unsigned int paramIndex = 1; paramIndex < paramsCount; paramIndex++) {
+        if (paramsTypes[paramIndex] != PARAM_TYPE_SEND || ((SendParams*)params[paramIndex])->minQuality == 0) {
+            continue;
+        }
+        unsigned int sendQuality = atomic_load(&((SendParams*)params[paramIndex])->videoUDPSender->quality);
+        quality                  = sendQuality < quality ? sendQuality : quality;
+        adaptive                 = true;
+    }
+    if (adaptive) {
+        VideoCaptureSetQuality(captureParams->videoCapture, quality);
+    }
 }
 
 static inline void mainLoop() {
@@ -679,66 +1433,18 @@ static inline void mainLoop() {
         if (receivedSigint) {
             return;
         }
-        for (unsigned int paramIndex = 0; paramIndex < paramsCount; paramIndex++) {
+        adaptCaptureQuality();
 #ifdef MEASURE
-            paramsMetricsStart(paramIndex);
+        paramsMetricsStart(0, 0);
 #endif
-            bool frameDecoded = false;
-            switch (paramsTypes[paramIndex]) {
-                case PARAM_TYPE_CAPTURE: {
-                    CaptureParams* captureParams = params[paramIndex];
-                    VideoCaptureGetFrame(captureParams->videoCapture);
-                    jpegBufferLength = captureParams->videoCapture->leasedFrameBuffer->bytesUsed;
-                    jpegBuffer       = captureParams->videoCapture->leasedFrameBuffer->start;
-                    uTimestamp       = captureParams->videoCapture->leasedFrameBuffer->uTimestamp;
-                    break;
-                }
-                case PARAM_TYPE_RECEIVE: {
-                    ReceiveParams* receiveParams = params[paramIndex];
-                    if (!VideoUDPReceiverReceiveFrame(receiveParams->videoUDPReceiver)) {
-                        return;
-                    }
-                    jpegBufferLength = receiveParams->videoUDPReceiver->jpegBufferLength;
-                    jpegBuffer       = receiveParams->videoUDPReceiver->jpegBuffer;
-                    uTimestamp       = receiveParams->videoUDPReceiver->uTimestamp;
-                    break;
-                }
-                case PARAM_TYPE_RENDER: {
-                    RenderParams* renderParams = params[paramIndex];
-                    if (!frameDecoded) {
-                        VideoDecoderDecodeFrame(videoDecoder, jpegBuffer, jpegBufferLength);
-                        frameDecoded = true;
-                    }
-                    VideoRendererRender(renderParams->videoRenderer, videoDecoder->rgbBuffer);
-                    break;
-                }
-                case PARAM_TYPE_RECORD: {
-                    RecordParams* recordParams = params[paramIndex];
-                    VideoRecorderRecordFrame(recordParams->videoRecorder, uTimestamp, jpegBuffer, jpegBufferLength);
-                    break;
-                }
-                case PARAM_TYPE_SEND: {
-                    SendParams* sendParams = params[paramIndex];
-                    VideoUDPSenderSendFrame(sendParams->videoUDPSender, uTimestamp, jpegBuffer, jpegBufferLength, sendParams->sendRounds);
-                    break;
-                }
-                case PARAM_TYPE_PIPE: {
-                    PipeParams* pipeParams = params[paramIndex];
-                    if (pipeParams->rgb && !frameDecoded) {
-                        VideoDecoderDecodeFrame(videoDecoder, jpegBuffer, jpegBufferLength);
-                        frameDecoded = true;
-                    }
-                    VideoPipeWriteFrame(pipeParams->videoPipe, uTimestamp, pipeParams->rgb ? videoDecoder->rgbBuffer : jpegBuffer, pipeParams->rgb ? videoDecoder->rgbBufferLength : jpegBufferLength);
-                    break;
-                }
-            }
+        VideoFrame* videoFrame = getFrame();
+        if (videoFrame == NULL) {
+            return;
+        }
 #ifdef MEASURE
-            paramsMetricsEnd(paramIndex);
+        paramsMetricsEnd(0, videoFrame->uTimestamp);
 #endif
-        }
-        if (paramsTypes[0] == PARAM_TYPE_CAPTURE) {
-            VideoCaptureReturnFrame(((CaptureParams*)params[0])->videoCapture);
-        }
+        scheduleFrame(videoFrame);
 #ifdef MEASURE
         frameMetricsEnd();
 #endif
@@ -757,14 +1463,17 @@ static inline void freeAll() {
             case PARAM_TYPE_RECEIVE: {
                 ReceiveParams* receiveParams = params[paramIndex];
                 VideoUDPReceiverFree(receiveParams->videoUDPReceiver);
+                if (receiveParams->videoJitterBuffer != NULL) {
+                    VideoJitterBufferFree(receiveParams->videoJitterBuffer);
+                }
                 free(receiveParams->localAddress);
-                free(receiveParams->jpegBuffer);
                 free(receiveParams);
                 break;
             }
             case PARAM_TYPE_RENDER: {
                 RenderParams* renderParams = params[paramIndex];
                 VideoRendererFree(renderParams->videoRenderer);
+                VideoDecoderFree(renderParams->videoDecoder);
                 free(renderParams);
                 break;
             }
@@ -777,21 +1486,42 @@ static inline void freeAll() {
             case PARAM_TYPE_SEND: {
                 SendParams* sendParams = params[paramIndex];
                 VideoUDPSenderFree(sendParams->videoUDPSender);
+                if (sendParams->videoTranscoder != NULL) {
+                    VideoTranscoderFree(sendParams->videoTranscoder);
+                }
                 free(sendParams->localAddress);
-                free(sendParams->remoteAddress);
+                free(sendParams->remoteAddresses);
                 free(sendParams);
                 break;
             }
             case PARAM_TYPE_PIPE: {
                 PipeParams* pipeParams = params[paramIndex];
                 VideoPipeFree(pipeParams->videoPipe);
+                if (pipeParams->videoDecoder != NULL) {
+                    VideoDecoderFree(pipeParams->videoDecoder);
+                }
                 free(pipeParams);
                 break;
             }
+            case PARAM_TYPE_STREAM_RECEIVE: {
+                StreamReceiveParams* streamReceiveParams = params[paramIndex];
+                VideoStreamReceiverFree(streamReceiveParams->videoStreamReceiver);
+                free(streamReceiveParams);
+                break;
+            }
+            case PARAM_TYPE_STREAM_SEND: {
+                StreamSendParams* streamSendParams = params[paramIndex];
+                VideoStreamSenderFree(streamSendParams->videoStreamSender);
+                free(streamSendParams);
+                break;
+            }
+        }
+        if (paramsQueues[paramIndex] != NULL) {
+            VideoQueueFree(paramsQueues[paramIndex]);
         }
     }
-    if (videoDecoder != NULL) {
-        VideoDecoderFree(videoDecoder);
+    if (videoFramePool != NULL) {
+        VideoFramePoolFree(videoFramePool);
     }
     exit(EXIT_SUCCESS);
 }
@@ -803,6 +1533,9 @@ static inline void receiveSigint(int signal) {
         ReceiveParams* receiveParams = params[0];
         close(receiveParams->videoUDPReceiver->fd);
         receiveParams->videoUDPReceiver->fd = -1;
+    } else if (paramsTypes[0] == PARAM_TYPE_STREAM_RECEIVE) {
+        StreamReceiveParams* streamReceiveParams = params[0];
+        VideoStreamReceiverClose(streamReceiveParams->videoStreamReceiver);
     }
 }
 
@@ -817,12 +1550,14 @@ int main(int argc, char** argv) {
     }
     parseParams(argc, argv);
     validateParams();
-    createVideoDecoderIfRequired();
+    createVideoFramePoolIfRequired();
     signal(SIGINT, receiveSigint);
 #ifdef MEASURE
     createMetrics();
 #endif
+    startOutputs();
     mainLoop();
+    stopOutputs();
 #ifdef MEASURE
     printMetrics();
     destroyMetrics();
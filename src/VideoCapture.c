@@ -2,6 +2,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/videodev2.h>
+#include <poll.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -33,7 +35,47 @@ static int xioctl(int fd, long unsigned int requestCode, void* arg) {
     }
 }
 
-VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth, unsigned int resolutionHeight, unsigned int timebaseNumerator, unsigned int timebaseDenominator) {
+static unsigned int getAutoBufferCount(unsigned int timebaseNumerator, unsigned int timebaseDenominator) {
+    uint64_t uFrameInterval = timebaseDenominator == 0 ? 0 : (uint64_t)timebaseNumerator * 1000000 / timebaseDenominator;
+    if (uFrameInterval == 0) {
+        return VIDEO_CAPTURE_MAX_BUFFER_COUNT;
+    }
+    uint64_t bufferCount = VIDEO_CAPTURE_MIN_BUFFER_COUNT + (VIDEO_CAPTURE_AUTO_STALL_USECONDS + uFrameInterval - 1) / uFrameInterval;
+    return bufferCount > VIDEO_CAPTURE_MAX_BUFFER_COUNT ? VIDEO_CAPTURE_MAX_BUFFER_COUNT : bufferCount;
+}
+
+static void probeQualityControl(VideoCapture* videoCapture) {
+    struct v4l2_queryctrl v4l2QueryControl;
+    memset(&v4l2QueryControl, 0, sizeof(v4l2QueryControl));
+    v4l2QueryControl.id = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+    if (xioctl(videoCapture->fd, VIDIOC_QUERYCTRL, &v4l2QueryControl) == -1 || (v4l2QueryControl.flags & (V4L2_CTRL_FLAG_DISABLED | V4L2_CTRL_FLAG_READ_ONLY))) {
+        return;
+    }
+    struct v4l2_control v4l2Control;
+    memset(&v4l2Control, 0, sizeof(v4l2Control));
+    v4l2Control.id = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+    if (xioctl(videoCapture->fd, VIDIOC_G_CTRL, &v4l2Control) == -1 || xioctl(videoCapture->fd, VIDIOC_S_CTRL, &v4l2Control) == -1 || v4l2Control.value <= v4l2QueryControl.minimum) {
+        return;
+    }
+    videoCapture->qualityControl = true;
+    videoCapture->qualityMinimum = v4l2QueryControl.minimum;
+    videoCapture->qualityDefault = v4l2Control.value;
+}
+
+static void releaseFrame(VideoFrame* videoFrame) {
+    VideoCapture*      videoCapture = videoFrame->owner;
+    struct v4l2_buffer v4l2Buffer;
+    memset(&v4l2Buffer, 0, sizeof(v4l2Buffer));
+    v4l2Buffer.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    v4l2Buffer.memory = V4L2_MEMORY_MMAP;
+    v4l2Buffer.index  = videoFrame->index;
+    if (xioctl(videoCapture->fd, VIDIOC_QBUF, &v4l2Buffer) == -1) {
+        fprintf(stderr, "Error: Unexpected error queueing frame buffer VIDIOC_QBUF.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth, unsigned int resolutionHeight, unsigned int timebaseNumerator, unsigned int timebaseDenominator, unsigned int bufferCount, bool latest) {
     VideoCapture* videoCapture = malloc(sizeof(VideoCapture));
     if (videoCapture == NULL) {
         fprintf(stderr, "Error: Unable to allocate memory for VideoCapture.\n");
@@ -41,18 +83,8 @@ VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth,
     }
     memset(videoCapture, 0, sizeof(VideoCapture));
     videoCapture->epochTimeShift = getEpochTimeShift();
-    videoCapture->leasedFrameBuffer = malloc(sizeof(FrameBuffer));
-    if (videoCapture->leasedFrameBuffer == NULL) {
-        fprintf(stderr, "Error: Unable to allocate memory for VideoCapture leased frame buffer.\n");
-        exit(EXIT_FAILURE);
-    }
-    memset(videoCapture->leasedFrameBuffer, 0, sizeof(FrameBuffer));
-    videoCapture->leasedV4l2Buffer = malloc(sizeof(struct v4l2_buffer));
-    if (videoCapture->leasedV4l2Buffer == NULL) {
-        fprintf(stderr, "Error: Unable to allocate memory for VideoCapture leased V4L2 buffer.\n");
-        exit(EXIT_FAILURE);
-    }
-    memset(videoCapture->leasedV4l2Buffer, 0, sizeof(struct v4l2_buffer));
+    videoCapture->latest         = latest;
+    videoCapture->quality        = VIDEO_CAPTURE_MAX_QUALITY;
     struct stat fileStats;
     memset(&fileStats, 0, sizeof(fileStats));
     if (stat(deviceName, &fileStats) == -1) {
@@ -63,7 +95,7 @@ VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth,
         fprintf(stderr, "Error: Device was not a special character file desriptor.\n");
         exit(EXIT_FAILURE);
     }
-    videoCapture->fd = open(deviceName, O_RDWR, 0);
+    videoCapture->fd = open(deviceName, latest ? O_RDWR | O_NONBLOCK : O_RDWR, 0);
     if (videoCapture->fd == -1) {
         fprintf(stderr, "Error: Couln't open device.\n");
         exit(EXIT_FAILURE);
@@ -109,25 +141,28 @@ VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth,
         fprintf(stderr, "Error: Unexpected error setting device stream paramaters VIDIOC_S_PARM.\n");
         exit(EXIT_FAILURE);
     }
+    probeQualityControl(videoCapture);
     struct v4l2_requestbuffers v4l2RequestBuffers;
     memset(&v4l2RequestBuffers, 0, sizeof(v4l2RequestBuffers));
-    v4l2RequestBuffers.count  = VIDEO_CAPTURE_BUFFER_COUNT;
+    v4l2RequestBuffers.count  = bufferCount == VIDEO_CAPTURE_AUTO_BUFFER_COUNT ? getAutoBufferCount(timebaseNumerator, timebaseDenominator) : bufferCount;
     v4l2RequestBuffers.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     v4l2RequestBuffers.memory = V4L2_MEMORY_MMAP;
     if (xioctl(videoCapture->fd, VIDIOC_REQBUFS, &v4l2RequestBuffers) == -1) {
         fprintf(stderr, "Error: Unexpected error requesting buffers VIDIOC_REQBUFS.\n");
         exit(EXIT_FAILURE);
     }
-    if (v4l2RequestBuffers.count != VIDEO_CAPTURE_BUFFER_COUNT) {
-        fprintf(stderr, "Error: Device did not accept requested number of buffers.\n");
+    if (v4l2RequestBuffers.count == 0) {
+        fprintf(stderr, "Error: Device did not grant any buffers.\n");
         exit(EXIT_FAILURE);
     }
-    videoCapture->frameBuffers = malloc(sizeof(FrameBuffer) * VIDEO_CAPTURE_BUFFER_COUNT);
-    if (!videoCapture->frameBuffers) {
+    videoCapture->frameCount = v4l2RequestBuffers.count;
+    videoCapture->frames     = malloc(sizeof(VideoFrame) * videoCapture->frameCount);
+    if (!videoCapture->frames) {
         fprintf(stderr, "Error: Unable to allocate memory for frame buffers.\n");
         exit(EXIT_FAILURE);
     }
-    for (unsigned int frameBufferIndex = 0; frameBufferIndex < VIDEO_CAPTURE_BUFFER_COUNT; frameBufferIndex++) {
+    memset(videoCapture->frames, 0, sizeof(VideoFrame) * videoCapture->frameCount);
+    for (unsigned int frameBufferIndex = 0; frameBufferIndex < videoCapture->frameCount; frameBufferIndex++) {
         struct v4l2_buffer v4l2Buffer;
         memset(&v4l2Buffer, 0, sizeof(v4l2Buffer));
         v4l2Buffer.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -137,14 +172,19 @@ VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth,
             fprintf(stderr, "Error: Unexpected error querying frame buffer VIDIOC_QUERYBUF.\n");
             exit(EXIT_FAILURE);
         }
-        videoCapture->frameBuffers[frameBufferIndex].length = v4l2Buffer.length;
-        videoCapture->frameBuffers[frameBufferIndex].start  = mmap(NULL, v4l2Buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, videoCapture->fd, v4l2Buffer.m.offset);
-        if (videoCapture->frameBuffers[frameBufferIndex].start == MAP_FAILED) {
+        VideoFrame* videoFrame         = &videoCapture->frames[frameBufferIndex];
+        videoFrame->index              = frameBufferIndex;
+        videoFrame->releaseCallback    = releaseFrame;
+        videoFrame->owner              = videoCapture;
+        videoFrame->jpegBufferCapacity = v4l2Buffer.length;
+        videoFrame->jpegBuffer         = mmap(NULL, v4l2Buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, videoCapture->fd, v4l2Buffer.m.offset);
+        atomic_init(&videoFrame->references, 0);
+        if (videoFrame->jpegBuffer == MAP_FAILED) {
             fprintf(stderr, "Error: Unexpected error mapping frame buffer memory MAP_FAILED.\n");
             exit(EXIT_FAILURE);
         }
     }
-    for (unsigned frameBufferIndex = 0; frameBufferIndex < VIDEO_CAPTURE_BUFFER_COUNT; frameBufferIndex++) {
+    for (unsigned frameBufferIndex = 0; frameBufferIndex < videoCapture->frameCount; frameBufferIndex++) {
         struct v4l2_buffer v4l2Buffer;
         memset(&v4l2Buffer, 0, sizeof(v4l2Buffer));
         v4l2Buffer.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -164,24 +204,67 @@ VideoCapture* VideoCaptureCreate(char* deviceName, unsigned int resolutionWidth,
     return videoCapture;
 }
 
-void VideoCaptureGetFrame(VideoCapture* videoCapture) {
-    memset(videoCapture->leasedV4l2Buffer, 0, sizeof(struct v4l2_buffer));
-    videoCapture->leasedV4l2Buffer->type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    videoCapture->leasedV4l2Buffer->memory = V4L2_MEMORY_MMAP;
-    if (xioctl(videoCapture->fd, VIDIOC_DQBUF, videoCapture->leasedV4l2Buffer) == -1) {
+static bool dequeueFrame(VideoCapture* videoCapture, struct v4l2_buffer* v4l2Buffer) {
+    memset(v4l2Buffer, 0, sizeof(struct v4l2_buffer));
+    v4l2Buffer->type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    v4l2Buffer->memory = V4L2_MEMORY_MMAP;
+    if (xioctl(videoCapture->fd, VIDIOC_DQBUF, v4l2Buffer) == -1) {
+        if (errno == EAGAIN) {
+            return false;
+        }
         fprintf(stderr, "Error: Unexpected error dequeueing frame buffer VIDIOC_DQBUF.\n");
         exit(EXIT_FAILURE);
     }
-    videoCapture->leasedFrameBuffer = &videoCapture->frameBuffers[videoCapture->leasedV4l2Buffer->index];
-    videoCapture->leasedFrameBuffer->bytesUsed = videoCapture->leasedV4l2Buffer->bytesused;
-    videoCapture->leasedFrameBuffer->uTimestamp = videoCapture->leasedV4l2Buffer->timestamp.tv_sec * 1000000 + videoCapture->leasedV4l2Buffer->timestamp.tv_usec + videoCapture->epochTimeShift;
+    if (videoCapture->lastSequenceInitialized && v4l2Buffer->sequence > videoCapture->lastSequence + 1) {
+        videoCapture->droppedFrameCount += v4l2Buffer->sequence - videoCapture->lastSequence - 1;
+    }
+    videoCapture->lastSequence            = v4l2Buffer->sequence;
+    videoCapture->lastSequenceInitialized = true;
+    return true;
 }
 
-void VideoCaptureReturnFrame(VideoCapture* videoCapture) {
-    if (xioctl(videoCapture->fd, VIDIOC_QBUF, videoCapture->leasedV4l2Buffer) == -1) {
-        fprintf(stderr, "Error: Unexpected error queueing frame buffer VIDIOC_QBUF.\n");
+VideoFrame* VideoCaptureGetFrame(VideoCapture* videoCapture) {
+    struct v4l2_buffer v4l2Buffer;
+    if (videoCapture->latest) {
+        struct pollfd pollFileDescriptor;
+        memset(&pollFileDescriptor, 0, sizeof(pollFileDescriptor));
+        pollFileDescriptor.fd     = videoCapture->fd;
+        pollFileDescriptor.events = POLLIN;
+        while (!dequeueFrame(videoCapture, &v4l2Buffer)) {
+            if (poll(&pollFileDescriptor, 1, -1) == -1 && errno != EINTR) {
+                fprintf(stderr, "Error: Unexpected error polling device.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        struct v4l2_buffer newerV4l2Buffer;
+        while (dequeueFrame(videoCapture, &newerV4l2Buffer)) {
+            releaseFrame(&videoCapture->frames[v4l2Buffer.index]);
+            videoCapture->skippedFrameCount++;
+            v4l2Buffer = newerV4l2Buffer;
+        }
+    } else {
+        dequeueFrame(videoCapture, &v4l2Buffer);
+    }
+    VideoFrame* videoFrame       = &videoCapture->frames[v4l2Buffer.index];
+    videoFrame->jpegBufferLength = v4l2Buffer.bytesused;
+    videoFrame->uTimestamp       = v4l2Buffer.timestamp.tv_sec * 1000000 + v4l2Buffer.timestamp.tv_usec + videoCapture->epochTimeShift;
+    atomic_store(&videoFrame->references, 1);
+    return videoFrame;
+}
+
+void VideoCaptureSetQuality(VideoCapture* videoCapture, unsigned int quality) {
+    if (!videoCapture->qualityControl || quality == videoCapture->quality) {
+        return;
+    }
+    struct v4l2_control v4l2Control;
+    memset(&v4l2Control, 0, sizeof(v4l2Control));
+    v4l2Control.id    = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+    v4l2Control.value = videoCapture->qualityMinimum + (videoCapture->qualityDefault - videoCapture->qualityMinimum) * (int)quality / VIDEO_CAPTURE_MAX_QUALITY;
+    if (xioctl(videoCapture->fd, VIDIOC_S_CTRL, &v4l2Control) == -1) {
+        fprintf(stderr, "Error: Unexpected error setting JPEG quality VIDIOC_S_CTRL.\n");
         exit(EXIT_FAILURE);
     }
+    videoCapture->quality = quality;
 }
 
 void VideoCaptureFree(VideoCapture* videoCapture) {
@@ -191,13 +274,13 @@ void VideoCaptureFree(VideoCapture* videoCapture) {
         fprintf(stderr, "Error: Unexpected error stopping stream VIDIOC_STREAMOFF.\n");
         exit(EXIT_FAILURE);
     }
-    for (unsigned int frameBufferIndex = 0; frameBufferIndex < VIDEO_CAPTURE_BUFFER_COUNT; frameBufferIndex++) {
-        if (munmap(videoCapture->frameBuffers[frameBufferIndex].start, videoCapture->frameBuffers[frameBufferIndex].length) == -1) {
+    for (unsigned int frameBufferIndex = 0; frameBufferIndex < videoCapture->frameCount; frameBufferIndex++) {
+        if (munmap(videoCapture->frames[frameBufferIndex].jpegBuffer, videoCapture->frames[frameBufferIndex].jpegBufferCapacity) == -1) {
             fprintf(stderr, "Error: Unexpected error unmapping frame buffer memory munmap.\n");
             exit(EXIT_FAILURE);
         }
     }
-    free(videoCapture->frameBuffers);
+    free(videoCapture->frames);
     if (close(videoCapture->fd) == -1) {
         fprintf(stderr, "Error: Unexpected error closing device file descriptor.\n");
         exit(EXIT_FAILURE);
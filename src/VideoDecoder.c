@@ -28,8 +28,8 @@ VideoDecoder* VideoDecoderCreate(unsigned int width, unsigned int height) {
 }
 
 void VideoDecoderDecodeFrame(VideoDecoder* videoDecoder, void* jpeg, unsigned int jpegLength) {
-    if (tjDecompress2(videoDecoder->tjHandle, jpeg, jpegLength, videoDecoder->rgbBuffer, videoDecoder->width, 0, videoDecoder->height, TJPF_RGB, 0) < 0) {
-        fprintf(stderr, "JPEG decompression error: %s\n", tjGetErrorStr());
+    if (tjDecompress2(videoDecoder->tjHandle, jpeg, jpegLength, videoDecoder->rgbBuffer, videoDecoder->width, 0, videoDecoder->height, TJPF_RGB, 0) < 0 && tjGetErrorCode(videoDecoder->tjHandle) != TJERR_WARNING) {
+        fprintf(stderr, "JPEG decompression error: %s\n", tjGetErrorStr2(videoDecoder->tjHandle));
         exit(EXIT_FAILURE);
     }
 }
@@ -0,0 +1,89 @@
+#include "../include/VideoFrame.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void releasePoolFrame(VideoFrame* videoFrame) {
+    VideoFramePool* videoFramePool = videoFrame->owner;
+    pthread_mutex_lock(&videoFramePool->mutex);
+    videoFramePool->freeFrames[videoFramePool->freeFrameCount++] = videoFrame;
+    pthread_cond_signal(&videoFramePool->frameReleased);
+    pthread_mutex_unlock(&videoFramePool->mutex);
+}
+
+void VideoFrameRetain(VideoFrame* videoFrame, unsigned int count) {
+    atomic_fetch_add(&videoFrame->references, count);
+}
+
+void VideoFrameRelease(VideoFrame* videoFrame) {
+    if (atomic_fetch_sub(&videoFrame->references, 1) == 1) {
+        videoFrame->releaseCallback(videoFrame);
+    }
+}
+
+VideoFramePool* VideoFramePoolCreate(unsigned int frameCount, unsigned int jpegBufferCapacity) {
+    VideoFramePool* videoFramePool = malloc(sizeof(VideoFramePool));
+    if (videoFramePool == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoFramePool.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoFramePool, 0, sizeof(VideoFramePool));
+    videoFramePool->frameCount = frameCount;
+    videoFramePool->frames     = malloc(frameCount * sizeof(VideoFrame));
+    if (videoFramePool->frames == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoFramePool frames.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoFramePool->frames, 0, frameCount * sizeof(VideoFrame));
+    videoFramePool->freeFrames = malloc(frameCount * sizeof(VideoFrame*));
+    if (videoFramePool->freeFrames == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoFramePool free frames.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+        VideoFrame* videoFrame         = &videoFramePool->frames[frameIndex];
+        videoFrame->jpegBufferCapacity = jpegBufferCapacity;
+        videoFrame->jpegBuffer         = malloc(jpegBufferCapacity);
+        if (videoFrame->jpegBuffer == NULL) {
+            fprintf(stderr, "Error: Unable to allocate memory for VideoFramePool jpeg buffer.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(videoFrame->jpegBuffer, 0, jpegBufferCapacity);
+        videoFrame->index           = frameIndex;
+        videoFrame->releaseCallback = releasePoolFrame;
+        videoFrame->owner           = videoFramePool;
+        atomic_init(&videoFrame->references, 0);
+        videoFramePool->freeFrames[frameIndex] = videoFrame;
+    }
+    videoFramePool->freeFrameCount = frameCount;
+    pthread_mutex_init(&videoFramePool->mutex, NULL);
+    pthread_cond_init(&videoFramePool->frameReleased, NULL);
+    return videoFramePool;
+}
+
+VideoFrame* VideoFramePoolAcquire(VideoFramePool* videoFramePool) {
+    pthread_mutex_lock(&videoFramePool->mutex);
+    while (videoFramePool->freeFrameCount == 0) {
+        pthread_cond_wait(&videoFramePool->frameReleased, &videoFramePool->mutex);
+    }
+    VideoFrame* videoFrame = videoFramePool->freeFrames[--videoFramePool->freeFrameCount];
+    pthread_mutex_unlock(&videoFramePool->mutex);
+    videoFrame->jpegBufferLength = 0;
+    videoFrame->uTimestamp       = 0;
+    atomic_store(&videoFrame->references, 1);
+    return videoFrame;
+}
+
+void VideoFramePoolFree(VideoFramePool* videoFramePool) {
+    for (unsigned int frameIndex = 0; frameIndex < videoFramePool->frameCount; frameIndex++) {
+        free(videoFramePool->frames[frameIndex].jpegBuffer);
+    }
+    pthread_mutex_destroy(&videoFramePool->mutex);
+    pthread_cond_destroy(&videoFramePool->frameReleased);
+    free(videoFramePool->freeFrames);
+    free(videoFramePool->frames);
+    free(videoFramePool);
+}
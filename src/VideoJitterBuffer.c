@@ -0,0 +1,146 @@
+#include "../include/VideoJitterBuffer.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t getMonotonicUSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void updateEstimates(VideoJitterBuffer* videoJitterBuffer, int64_t transit) {
+    int64_t transitDelta = transit - videoJitterBuffer->lastTransit;
+    if (transitDelta < 0) {
+        transitDelta = -transitDelta;
+    }
+    if (!videoJitterBuffer->hasTransit || transitDelta > VIDEO_JITTER_BUFFER_RESET_USECONDS) {
+        videoJitterBuffer->hasTransit     = true;
+        videoJitterBuffer->baseTransit    = transit;
+        videoJitterBuffer->jitterUSeconds = 0;
+        videoJitterBuffer->excessUSeconds = 0;
+    } else {
+        videoJitterBuffer->jitterUSeconds = (videoJitterBuffer->jitterUSeconds * (VIDEO_JITTER_BUFFER_JITTER_GAIN - 1) + transitDelta) / VIDEO_JITTER_BUFFER_JITTER_GAIN;
+        videoJitterBuffer->baseTransit += videoJitterBuffer->frameIntervalUSeconds / VIDEO_JITTER_BUFFER_DRIFT_DIVISOR;
+        if (transit < videoJitterBuffer->baseTransit) {
+            videoJitterBuffer->baseTransit = transit;
+        }
+        videoJitterBuffer->excessUSeconds = (videoJitterBuffer->excessUSeconds * (VIDEO_JITTER_BUFFER_JITTER_GAIN - 1) + (transit - videoJitterBuffer->baseTransit)) / VIDEO_JITTER_BUFFER_JITTER_GAIN;
+    }
+    videoJitterBuffer->lastTransit         = transit;
+    videoJitterBuffer->targetDelayUSeconds = videoJitterBuffer->excessUSeconds + VIDEO_JITTER_BUFFER_JITTER_MULTIPLIER * videoJitterBuffer->jitterUSeconds;
+    if (videoJitterBuffer->targetDelayUSeconds > videoJitterBuffer->maxDelayUSeconds) {
+        videoJitterBuffer->targetDelayUSeconds = videoJitterBuffer->maxDelayUSeconds;
+    }
+}
+
+VideoJitterBuffer* VideoJitterBufferCreate(unsigned int maxDelayMSeconds, unsigned int timebaseNumerator, unsigned int timebaseDenominator) {
+    if (timebaseNumerator == 0 || timebaseDenominator == 0) {
+        fprintf(stderr, "Error: VideoJitterBuffer needs a non zero timebase.\n");
+        exit(EXIT_FAILURE);
+    }
+    VideoJitterBuffer* videoJitterBuffer = malloc(sizeof(VideoJitterBuffer));
+    if (videoJitterBuffer == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoJitterBuffer.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoJitterBuffer, 0, sizeof(VideoJitterBuffer));
+    videoJitterBuffer->maxDelayUSeconds      = (uint64_t)maxDelayMSeconds * 1000;
+    videoJitterBuffer->frameIntervalUSeconds = (uint64_t)timebaseNumerator * 1000000 / timebaseDenominator;
+    videoJitterBuffer->capacity              = videoJitterBuffer->maxDelayUSeconds / (videoJitterBuffer->frameIntervalUSeconds > 0 ? videoJitterBuffer->frameIntervalUSeconds : 1) + 2;
+    videoJitterBuffer->frames                = malloc(videoJitterBuffer->capacity * sizeof(VideoFrame*));
+    if (videoJitterBuffer->frames == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoJitterBuffer frames.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoJitterBuffer->playoutUTimes = malloc(videoJitterBuffer->capacity * sizeof(uint64_t));
+    if (videoJitterBuffer->playoutUTimes == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoJitterBuffer playout times.\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_condattr_t conditionAttributes;
+    pthread_condattr_init(&conditionAttributes);
+    pthread_condattr_setclock(&conditionAttributes, CLOCK_MONOTONIC);
+    pthread_mutex_init(&videoJitterBuffer->mutex, NULL);
+    pthread_cond_init(&videoJitterBuffer->changed, &conditionAttributes);
+    pthread_condattr_destroy(&conditionAttributes);
+    return videoJitterBuffer;
+}
+
+VideoFrame* VideoJitterBufferPush(VideoJitterBuffer* videoJitterBuffer, VideoFrame* videoFrame) {
+    uint64_t uNow = getMonotonicUSeconds();
+    pthread_mutex_lock(&videoJitterBuffer->mutex);
+    updateEstimates(videoJitterBuffer, (int64_t)(uNow - videoFrame->uTimestamp));
+    uint64_t playoutUTime = videoFrame->uTimestamp + videoJitterBuffer->baseTransit + videoJitterBuffer->targetDelayUSeconds;
+    if (playoutUTime > uNow + videoJitterBuffer->maxDelayUSeconds) {
+        playoutUTime = uNow + videoJitterBuffer->maxDelayUSeconds;
+    }
+    if (playoutUTime < videoJitterBuffer->lastPlayoutUTime) {
+        playoutUTime = videoJitterBuffer->lastPlayoutUTime;
+    }
+    if (playoutUTime < uNow) {
+        playoutUTime = uNow;
+        videoJitterBuffer->lateFrameCount++;
+    }
+    videoJitterBuffer->lastPlayoutUTime = playoutUTime;
+    VideoFrame* droppedFrame            = NULL;
+    if (videoJitterBuffer->count == videoJitterBuffer->capacity) {
+        droppedFrame            = videoJitterBuffer->frames[videoJitterBuffer->head];
+        videoJitterBuffer->head = (videoJitterBuffer->head + 1) % videoJitterBuffer->capacity;
+        videoJitterBuffer->count--;
+        videoJitterBuffer->droppedFrameCount++;
+    }
+    unsigned int tail                      = (videoJitterBuffer->head + videoJitterBuffer->count) % videoJitterBuffer->capacity;
+    videoJitterBuffer->frames[tail]        = videoFrame;
+    videoJitterBuffer->playoutUTimes[tail] = playoutUTime;
+    videoJitterBuffer->count++;
+    pthread_cond_signal(&videoJitterBuffer->changed);
+    pthread_mutex_unlock(&videoJitterBuffer->mutex);
+    return droppedFrame;
+}
+
+VideoFrame* VideoJitterBufferPop(VideoJitterBuffer* videoJitterBuffer) {
+    pthread_mutex_lock(&videoJitterBuffer->mutex);
+    while (!videoJitterBuffer->closed) {
+        if (videoJitterBuffer->count == 0) {
+            pthread_cond_wait(&videoJitterBuffer->changed, &videoJitterBuffer->mutex);
+            continue;
+        }
+        uint64_t playoutUTime = videoJitterBuffer->playoutUTimes[videoJitterBuffer->head];
+        if (playoutUTime <= getMonotonicUSeconds()) {
+            VideoFrame* videoFrame  = videoJitterBuffer->frames[videoJitterBuffer->head];
+            videoJitterBuffer->head = (videoJitterBuffer->head + 1) % videoJitterBuffer->capacity;
+            videoJitterBuffer->count--;
+            pthread_mutex_unlock(&videoJitterBuffer->mutex);
+            return videoFrame;
+        }
+        struct timespec deadline;
+        deadline.tv_sec  = playoutUTime / 1000000;
+        deadline.tv_nsec = (playoutUTime % 1000000) * 1000;
+        pthread_cond_timedwait(&videoJitterBuffer->changed, &videoJitterBuffer->mutex, &deadline);
+    }
+    pthread_mutex_unlock(&videoJitterBuffer->mutex);
+    return NULL;
+}
+
+void VideoJitterBufferClose(VideoJitterBuffer* videoJitterBuffer) {
+    pthread_mutex_lock(&videoJitterBuffer->mutex);
+    videoJitterBuffer->closed = true;
+    pthread_cond_broadcast(&videoJitterBuffer->changed);
+    pthread_mutex_unlock(&videoJitterBuffer->mutex);
+}
+
+void VideoJitterBufferFree(VideoJitterBuffer* videoJitterBuffer) {
+    for (unsigned int frameIndex = 0; frameIndex < videoJitterBuffer->count; frameIndex++) {
+        VideoFrameRelease(videoJitterBuffer->frames[(videoJitterBuffer->head + frameIndex) % videoJitterBuffer->capacity]);
+    }
+    pthread_mutex_destroy(&videoJitterBuffer->mutex);
+    pthread_cond_destroy(&videoJitterBuffer->changed);
+    free(videoJitterBuffer->playoutUTimes);
+    free(videoJitterBuffer->frames);
+    free(videoJitterBuffer);
+}
@@ -25,8 +25,8 @@ void VideoPipeWriteFrame(VideoPipe* videoPipe, uint64_t uTimestamp, void* start,
         fprintf(stderr, "Error writing timestamp to pipe. Wrote %ld bytes instead of %ld bytes.\n", bytesWritten, sizeof(uint64_t));
         exit(EXIT_FAILURE);
     }
-    length       = htobe32(length);
-    bytesWritten = write(videoPipe->fd, &length, sizeof(uint32_t));
+    uint32_t beLength = htobe32(length);
+    bytesWritten      = write(videoPipe->fd, &beLength, sizeof(uint32_t));
     if (bytesWritten < 0) {
         perror("Error writing length to pipe.");
         exit(EXIT_FAILURE);
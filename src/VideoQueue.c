@@ -0,0 +1,121 @@
+#include "../include/VideoQueue.h"
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static void waitEvent(VideoQueue* videoQueue, uint32_t seenEvent) {
+    atomic_fetch_add(&videoQueue->waiters, 1);
+    syscall(SYS_futex, &videoQueue->event, FUTEX_WAIT_PRIVATE, seenEvent, NULL, NULL, 0);
+    atomic_fetch_sub(&videoQueue->waiters, 1);
+}
+
+static void signalEvent(VideoQueue* videoQueue) {
+    atomic_fetch_add(&videoQueue->event, 1);
+    if (atomic_load(&videoQueue->waiters) > 0) {
+        syscall(SYS_futex, &videoQueue->event, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+VideoQueue* VideoQueueCreate(unsigned int capacity, unsigned int policy) {
+    if (capacity == 0) {
+        fprintf(stderr, "Error: VideoQueue capacity must be at least 1.\n");
+        exit(EXIT_FAILURE);
+    }
+    VideoQueue* videoQueue = malloc(sizeof(VideoQueue));
+    if (videoQueue == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoQueue.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoQueue, 0, sizeof(VideoQueue));
+    videoQueue->capacity = capacity;
+    videoQueue->policy   = policy;
+    videoQueue->items    = malloc(capacity * sizeof(_Atomic(void*)));
+    if (videoQueue->items == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoQueue items.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned int itemIndex = 0; itemIndex < capacity; itemIndex++) {
+        atomic_init(&videoQueue->items[itemIndex], NULL);
+    }
+    atomic_init(&videoQueue->head, 0);
+    atomic_init(&videoQueue->tail, 0);
+    atomic_init(&videoQueue->event, 0);
+    atomic_init(&videoQueue->waiters, 0);
+    atomic_init(&videoQueue->closed, false);
+    atomic_init(&videoQueue->droppedCount, 0);
+    return videoQueue;
+}
+
+void* VideoQueuePush(VideoQueue* videoQueue, void* item) {
+    for (;;) {
+        uint32_t seenEvent = atomic_load(&videoQueue->event);
+        if (atomic_load(&videoQueue->closed)) {
+            return item;
+        }
+        uint64_t head = atomic_load_explicit(&videoQueue->head, memory_order_relaxed);
+        uint64_t tail = atomic_load(&videoQueue->tail);
+        if (head - tail < videoQueue->capacity) {
+            atomic_store(&videoQueue->items[head % videoQueue->capacity], item);
+            atomic_store(&videoQueue->head, head + 1);
+            signalEvent(videoQueue);
+            return NULL;
+        }
+        switch (videoQueue->policy) {
+            case VIDEO_QUEUE_POLICY_DROP_NEWEST: {
+                atomic_fetch_add(&videoQueue->droppedCount, 1);
+                return item;
+            }
+            case VIDEO_QUEUE_POLICY_DROP_OLDEST: {
+                void* oldestItem = atomic_load(&videoQueue->items[tail % videoQueue->capacity]);
+                if (!atomic_compare_exchange_strong(&videoQueue->tail, &tail, tail + 1)) {
+                    continue;
+                }
+                atomic_fetch_add(&videoQueue->droppedCount, 1);
+                atomic_store(&videoQueue->items[head % videoQueue->capacity], item);
+                atomic_store(&videoQueue->head, head + 1);
+                signalEvent(videoQueue);
+                return oldestItem;
+            }
+            default: {
+                waitEvent(videoQueue, seenEvent);
+                break;
+            }
+        }
+    }
+}
+
+void* VideoQueuePop(VideoQueue* videoQueue) {
+    for (;;) {
+        uint32_t seenEvent = atomic_load(&videoQueue->event);
+        uint64_t tail      = atomic_load(&videoQueue->tail);
+        if (tail != atomic_load(&videoQueue->head)) {
+            void* item = atomic_load(&videoQueue->items[tail % videoQueue->capacity]);
+            if (!atomic_compare_exchange_strong(&videoQueue->tail, &tail, tail + 1)) {
+                continue;
+            }
+            signalEvent(videoQueue);
+            return item;
+        }
+        if (atomic_load(&videoQueue->closed)) {
+            return NULL;
+        }
+        waitEvent(videoQueue, seenEvent);
+    }
+}
+
+void VideoQueueClose(VideoQueue* videoQueue) {
+    atomic_store(&videoQueue->closed, true);
+    signalEvent(videoQueue);
+}
+
+void VideoQueueFree(VideoQueue* videoQueue) {
+    free(videoQueue->items);
+    free(videoQueue);
+}
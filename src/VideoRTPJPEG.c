@@ -0,0 +1,402 @@
+#include "../include/VideoRTPJPEG.h"
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t zigzag[64] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+static const uint8_t lumaQuantizer[64] = {
+    16, 11, 10, 16, 24,  40,  51,  61,
+    12, 12, 14, 19, 26,  58,  60,  55,
+    14, 13, 16, 24, 40,  57,  69,  56,
+    14, 17, 22, 29, 51,  87,  80,  62,
+    18, 22, 37, 56, 68,  109, 103, 77,
+    24, 35, 55, 64, 81,  104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101,
+    72, 92, 95, 98, 112, 100, 103, 99,
+};
+
+static const uint8_t chromaQuantizer[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99,
+    18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99,
+    47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,
+};
+
+static const uint8_t lumaDCCounts[16]    = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+static const uint8_t lumaDCSymbols[12]   = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const uint8_t chromaDCCounts[16]  = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+static const uint8_t chromaDCSymbols[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const uint8_t lumaACCounts[16]    = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D};
+static const uint8_t chromaACCounts[16]  = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77};
+
+static const uint8_t lumaACSymbols[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+    0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+    0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+    0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+};
+
+static const uint8_t chromaACSymbols[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+    0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+    0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+    0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+    0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+    0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+};
+
+typedef struct HuffmanTable {
+    uint8_t        tableClass;
+    uint8_t        tableId;
+    const uint8_t* counts;
+    const uint8_t* symbols;
+    uint32_t       symbolCount;
+} HuffmanTable;
+
+static const HuffmanTable huffmanTables[4] = {
+    {0, 0, lumaDCCounts, lumaDCSymbols, sizeof(lumaDCSymbols)},
+    {1, 0, lumaACCounts, lumaACSymbols, sizeof(lumaACSymbols)},
+    {0, 1, chromaDCCounts, chromaDCSymbols, sizeof(chromaDCSymbols)},
+    {1, 1, chromaACCounts, chromaACSymbols, sizeof(chromaACSymbols)},
+};
+
+static inline uint32_t readUInt16(const uint8_t* data) {
+    return ((uint32_t)data[0] << 8) | data[1];
+}
+
+static inline uint8_t* writeMarker(uint8_t* data, uint8_t markerCode, uint32_t segmentLength) {
+    data[0] = 0xFF;
+    data[1] = markerCode;
+    if (segmentLength == 0) {
+        return data + 2;
+    }
+    data[2] = segmentLength >> 8;
+    data[3] = segmentLength & 0xFF;
+    return data + 4;
+}
+
+static bool readQuantizationTables(const uint8_t* segment, uint32_t segmentLength, uint8_t* quantizationTables, bool* tablesRead) {
+    uint32_t offset = 0;
+    while (offset < segmentLength) {
+        uint8_t precision = segment[offset] >> 4;
+        uint8_t tableId   = segment[offset] & 0x0F;
+        if (precision != 0 || tableId >= RTP_JPEG_QUANTIZATION_TABLE_COUNT || offset + 1 + RTP_JPEG_QUANTIZATION_TABLE_LENGTH > segmentLength) {
+            return false;
+        }
+        memcpy(quantizationTables + tableId * RTP_JPEG_QUANTIZATION_TABLE_LENGTH, segment + offset + 1, RTP_JPEG_QUANTIZATION_TABLE_LENGTH);
+        tablesRead[tableId] = true;
+        offset += 1 + RTP_JPEG_QUANTIZATION_TABLE_LENGTH;
+    }
+    return true;
+}
+
+static bool checkHuffmanTables(const uint8_t* segment, uint32_t segmentLength) {
+    uint32_t offset = 0;
+    while (offset < segmentLength) {
+        if (offset + 17 > segmentLength) {
+            return false;
+        }
+        uint8_t  tableClass  = segment[offset] >> 4;
+        uint8_t  tableId     = segment[offset] & 0x0F;
+        uint32_t symbolCount = 0;
+        for (unsigned int countIndex = 0; countIndex < 16; countIndex++) {
+            symbolCount += segment[offset + 1 + countIndex];
+        }
+        if (offset + 17 + symbolCount > segmentLength) {
+            return false;
+        }
+        bool standard = false;
+        for (unsigned int tableIndex = 0; tableIndex < 4; tableIndex++) {
+            const HuffmanTable* huffmanTable = &huffmanTables[tableIndex];
+            if (huffmanTable->tableClass == tableClass && huffmanTable->tableId == tableId && huffmanTable->symbolCount == symbolCount && memcmp(segment + offset + 1, huffmanTable->counts, 16) == 0 && memcmp(segment + offset + 17, huffmanTable->symbols, symbolCount) == 0) {
+                standard = true;
+                break;
+            }
+        }
+        if (!standard) {
+            return false;
+        }
+        offset += 17 + symbolCount;
+    }
+    return true;
+}
+
+static bool readFrameHeader(const uint8_t* segment, uint32_t segmentLength, VideoRTPJPEGFrame* videoRTPJPEGFrame) {
+    if (segmentLength != 6 + 3 * 3 || segment[0] != 8 || segment[5] != 3) {
+        return false;
+    }
+    videoRTPJPEGFrame->height = readUInt16(segment + 1);
+    videoRTPJPEGFrame->width  = readUInt16(segment + 3);
+    if (videoRTPJPEGFrame->width == 0 || videoRTPJPEGFrame->height == 0 || videoRTPJPEGFrame->width % 8 != 0 || videoRTPJPEGFrame->height % 8 != 0 || videoRTPJPEGFrame->width > RTP_JPEG_MAX_DIMENSION || videoRTPJPEGFrame->height > RTP_JPEG_MAX_DIMENSION) {
+        return false;
+    }
+    if (segment[7] == 0x21) {
+        videoRTPJPEGFrame->type = RTP_JPEG_TYPE_422;
+    } else if (segment[7] == 0x22) {
+        videoRTPJPEGFrame->type = RTP_JPEG_TYPE_420;
+    } else {
+        return false;
+    }
+    return segment[8] == 0 && segment[10] == 0x11 && segment[11] == 1 && segment[13] == 0x11 && segment[14] == 1;
+}
+
+static bool checkScanHeader(const uint8_t* segment, uint32_t segmentLength) {
+    if (segmentLength != 1 + 3 * 2 + 3 || segment[0] != 3) {
+        return false;
+    }
+    return segment[2] == 0x00 && segment[4] == 0x11 && segment[6] == 0x11 && segment[7] == 0 && segment[8] == 63 && segment[9] == 0;
+}
+
+void VideoRTPJPEGWriteRTPHeader(void* header, bool marker, uint16_t sequence, uint32_t timestamp, uint32_t ssrc) {
+    uint8_t* bytes       = header;
+    uint16_t beSequence  = htons(sequence);
+    uint32_t beTimestamp = htonl(timestamp);
+    uint32_t beSSRC      = htonl(ssrc);
+    bytes[0]             = RTP_VERSION << 6;
+    bytes[1]             = (marker ? 0x80 : 0x00) | RTP_PAYLOAD_TYPE_JPEG;
+    memcpy(bytes + 2, &beSequence, sizeof(uint16_t));
+    memcpy(bytes + 4, &beTimestamp, sizeof(uint32_t));
+    memcpy(bytes + 8, &beSSRC, sizeof(uint32_t));
+}
+
+bool VideoRTPJPEGReadRTPHeader(const void* packet, uint32_t packetLength, bool* marker, uint16_t* sequence, uint32_t* timestamp, uint32_t* ssrc, uint32_t* payloadOffset, uint32_t* payloadLength) {
+    const uint8_t* bytes = packet;
+    if (packetLength < RTP_HEADER_LENGTH || bytes[0] >> 6 != RTP_VERSION || (bytes[1] & 0x7F) != RTP_PAYLOAD_TYPE_JPEG) {
+        return false;
+    }
+    uint32_t offset = RTP_HEADER_LENGTH + (bytes[0] & 0x0F) * sizeof(uint32_t);
+    if ((bytes[0] & 0x10) && offset + sizeof(uint32_t) <= packetLength) {
+        offset += sizeof(uint32_t) + readUInt16(bytes + offset + 2) * sizeof(uint32_t);
+    } else if (bytes[0] & 0x10) {
+        return false;
+    }
+    if ((bytes[0] & 0x20) && bytes[packetLength - 1] <= packetLength) {
+        packetLength -= bytes[packetLength - 1];
+    }
+    if (offset > packetLength) {
+        return false;
+    }
+    *marker        = (bytes[1] & 0x80) != 0;
+    *sequence      = readUInt16(bytes + 2);
+    *timestamp     = ((uint32_t)readUInt16(bytes + 4) << 16) | readUInt16(bytes + 6);
+    *ssrc          = ((uint32_t)readUInt16(bytes + 8) << 16) | readUInt16(bytes + 10);
+    *payloadOffset = offset;
+    *payloadLength = packetLength - offset;
+    return true;
+}
+
+void VideoRTPJPEGWriteJPEGHeader(void* header, uint32_t fragmentOffset, uint8_t type, uint8_t quality, uint32_t width, uint32_t height) {
+    uint8_t* bytes = header;
+    bytes[0]       = 0;
+    bytes[1]       = fragmentOffset >> 16;
+    bytes[2]       = fragmentOffset >> 8;
+    bytes[3]       = fragmentOffset;
+    bytes[4]       = type;
+    bytes[5]       = quality;
+    bytes[6]       = width / 8;
+    bytes[7]       = height / 8;
+}
+
+void VideoRTPJPEGReadJPEGHeader(const void* header, uint32_t* fragmentOffset, uint8_t* type, uint8_t* quality, uint32_t* width, uint32_t* height) {
+    const uint8_t* bytes = header;
+    *fragmentOffset      = ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+    *type                = bytes[4];
+    *quality             = bytes[5];
+    *width               = bytes[6] * 8;
+    *height              = bytes[7] * 8;
+}
+
+void VideoRTPJPEGWriteRestartHeader(void* header, uint32_t restartInterval) {
+    uint8_t* bytes = header;
+    bytes[0]       = restartInterval >> 8;
+    bytes[1]       = restartInterval & 0xFF;
+    bytes[2]       = 0xFF;
+    bytes[3]       = 0xFF;
+}
+
+uint32_t VideoRTPJPEGReadRestartHeader(const void* header) {
+    return readUInt16(header);
+}
+
+void VideoRTPJPEGWriteQuantizationHeader(void* header, const uint8_t* quantizationTables) {
+    uint8_t* bytes = header;
+    bytes[0]       = 0;
+    bytes[1]       = 0;
+    bytes[2]       = RTP_JPEG_QUANTIZATION_TABLES_LENGTH >> 8;
+    bytes[3]       = RTP_JPEG_QUANTIZATION_TABLES_LENGTH & 0xFF;
+    memcpy(bytes + RTP_JPEG_QUANTIZATION_HEADER_LENGTH, quantizationTables, RTP_JPEG_QUANTIZATION_TABLES_LENGTH);
+}
+
+void VideoRTPJPEGReadQuantizationHeader(const void* header, uint8_t* precision, uint32_t* quantizationTablesLength) {
+    const uint8_t* bytes      = header;
+    *precision                = bytes[1];
+    *quantizationTablesLength = readUInt16(bytes + 2);
+}
+
+void VideoRTPJPEGMakeQuantizationTables(uint8_t quality, uint8_t* quantizationTables) {
+    unsigned int factor = quality < 1 ? 1 : quality > RTP_JPEG_MAX_QUALITY ? RTP_JPEG_MAX_QUALITY : quality;
+    unsigned int scale  = factor < 50 ? 5000 / factor : 200 - factor * 2;
+    for (unsigned int coefficientIndex = 0; coefficientIndex < 64; coefficientIndex++) {
+        unsigned int lumaValue   = (lumaQuantizer[zigzag[coefficientIndex]] * scale + 50) / 100;
+        unsigned int chromaValue = (chromaQuantizer[zigzag[coefficientIndex]] * scale + 50) / 100;
+        quantizationTables[coefficientIndex]                                      = lumaValue < 1 ? 1 : lumaValue > 255 ? 255 : lumaValue;
+        quantizationTables[RTP_JPEG_QUANTIZATION_TABLE_LENGTH + coefficientIndex] = chromaValue < 1 ? 1 : chromaValue > 255 ? 255 : chromaValue;
+    }
+}
+
+uint8_t VideoRTPJPEGFindQuality(const uint8_t* quantizationTables) {
+    uint8_t scaledTables[RTP_JPEG_QUANTIZATION_TABLES_LENGTH];
+    for (uint8_t quality = 1; quality <= RTP_JPEG_MAX_QUALITY; quality++) {
+        VideoRTPJPEGMakeQuantizationTables(quality, scaledTables);
+        if (memcmp(scaledTables, quantizationTables, RTP_JPEG_QUANTIZATION_TABLES_LENGTH) == 0) {
+            return quality;
+        }
+    }
+    return RTP_JPEG_DYNAMIC_QUALITY;
+}
+
+bool VideoRTPJPEGParseFrame(const uint8_t* jpeg, uint32_t jpegLength, VideoRTPJPEGFrame* videoRTPJPEGFrame) {
+    if (jpegLength < 4 || jpeg[0] != 0xFF || jpeg[1] != 0xD8) {
+        return false;
+    }
+    bool     tablesRead[RTP_JPEG_QUANTIZATION_TABLE_COUNT] = {false, false};
+    bool     frameRead                                     = false;
+    uint32_t offset                                        = 2;
+    videoRTPJPEGFrame->restartInterval                     = 0;
+    while (offset + 4 <= jpegLength) {
+        if (jpeg[offset] != 0xFF) {
+            return false;
+        }
+        uint8_t markerCode = jpeg[offset + 1];
+        if (markerCode == 0xFF) {
+            offset++;
+            continue;
+        }
+        uint32_t       segmentLength = readUInt16(jpeg + offset + 2);
+        const uint8_t* segment       = jpeg + offset + 4;
+        uint32_t       segmentEnd    = offset + 2 + segmentLength;
+        if (segmentLength < 2 || segmentEnd > jpegLength) {
+            return false;
+        }
+        segmentLength -= 2;
+        if (markerCode == 0xDB && !readQuantizationTables(segment, segmentLength, videoRTPJPEGFrame->quantizationTables, tablesRead)) {
+            return false;
+        }
+        if (markerCode == 0xC4 && !checkHuffmanTables(segment, segmentLength)) {
+            return false;
+        }
+        if (markerCode == 0xC0 && !readFrameHeader(segment, segmentLength, videoRTPJPEGFrame)) {
+            return false;
+        }
+        if (markerCode > 0xC0 && markerCode <= 0xCF && markerCode != 0xC4) {
+            return false;
+        }
+        if (markerCode == 0xDD && segmentLength != 2) {
+            return false;
+        }
+        frameRead = frameRead || markerCode == 0xC0;
+        if (markerCode == 0xDD) {
+            videoRTPJPEGFrame->restartInterval = readUInt16(segment);
+        }
+        if (markerCode == 0xDA) {
+            if (!frameRead || !tablesRead[0] || !tablesRead[1] || !checkScanHeader(segment, segmentLength)) {
+                return false;
+            }
+            uint32_t scanEnd = jpegLength;
+            while (scanEnd > segmentEnd + 1 && !(jpeg[scanEnd - 2] == 0xFF && jpeg[scanEnd - 1] == 0xD9)) {
+                scanEnd--;
+            }
+            scanEnd = scanEnd > segmentEnd + 1 ? scanEnd - RTP_JPEG_EOI_LENGTH : jpegLength;
+            if (videoRTPJPEGFrame->restartInterval > 0) {
+                videoRTPJPEGFrame->type |= RTP_JPEG_TYPE_RESTART;
+            }
+            videoRTPJPEGFrame->scanOffset = segmentEnd;
+            videoRTPJPEGFrame->scanLength = scanEnd - segmentEnd;
+            return videoRTPJPEGFrame->scanLength > 0;
+        }
+        offset = segmentEnd;
+    }
+    return false;
+}
+
+uint32_t VideoRTPJPEGGetHeadersLength(uint32_t restartInterval) {
+    return RTP_JPEG_HEADERS_LENGTH + (restartInterval > 0 ? RTP_JPEG_DRI_LENGTH : 0);
+}
+
+uint32_t VideoRTPJPEGWriteHeaders(void* jpeg, uint8_t type, const uint8_t* quantizationTables, uint32_t width, uint32_t height, uint32_t restartInterval) {
+    uint8_t* data = writeMarker(jpeg, 0xD8, 0);
+    data          = writeMarker(data, 0xDB, RTP_JPEG_DQT_LENGTH - 2);
+    for (uint8_t tableId = 0; tableId < RTP_JPEG_QUANTIZATION_TABLE_COUNT; tableId++) {
+        *data++ = tableId;
+        memcpy(data, quantizationTables + tableId * RTP_JPEG_QUANTIZATION_TABLE_LENGTH, RTP_JPEG_QUANTIZATION_TABLE_LENGTH);
+        data += RTP_JPEG_QUANTIZATION_TABLE_LENGTH;
+    }
+    data    = writeMarker(data, 0xC0, RTP_JPEG_SOF_LENGTH - 2);
+    *data++ = 8;
+    *data++ = height >> 8;
+    *data++ = height & 0xFF;
+    *data++ = width >> 8;
+    *data++ = width & 0xFF;
+    *data++ = 3;
+    for (uint8_t componentId = 1; componentId <= 3; componentId++) {
+        *data++ = componentId;
+        *data++ = componentId > 1 ? 0x11 : (type & ~RTP_JPEG_TYPE_RESTART) == RTP_JPEG_TYPE_420 ? 0x22 : 0x21;
+        *data++ = componentId > 1 ? 1 : 0;
+    }
+    data = writeMarker(data, 0xC4, RTP_JPEG_DHT_LENGTH - 2);
+    for (unsigned int tableIndex = 0; tableIndex < 4; tableIndex++) {
+        const HuffmanTable* huffmanTable = &huffmanTables[tableIndex];
+        *data++                          = (huffmanTable->tableClass << 4) | huffmanTable->tableId;
+        memcpy(data, huffmanTable->counts, 16);
+        memcpy(data + 16, huffmanTable->symbols, huffmanTable->symbolCount);
+        data += 16 + huffmanTable->symbolCount;
+    }
+    if (restartInterval > 0) {
+        data    = writeMarker(data, 0xDD, RTP_JPEG_DRI_LENGTH - 2);
+        *data++ = restartInterval >> 8;
+        *data++ = restartInterval & 0xFF;
+    }
+    data    = writeMarker(data, 0xDA, RTP_JPEG_SOS_LENGTH - 2);
+    *data++ = 3;
+    for (uint8_t componentId = 1; componentId <= 3; componentId++) {
+        *data++ = componentId;
+        *data++ = componentId > 1 ? 0x11 : 0x00;
+    }
+    *data++ = 0;
+    *data++ = 63;
+    *data++ = 0;
+    return data - (uint8_t*)jpeg;
+}
+
+uint64_t VideoRTPJPEGGetUTimestamp(uint32_t timestamp, uint64_t uNow) {
+    uint64_t nowTimestamp  = uNow * (RTP_CLOCK_RATE / 1000) / 1000;
+    uint64_t fullTimestamp = nowTimestamp + (int32_t)(timestamp - (uint32_t)nowTimestamp);
+    return fullTimestamp * 1000 / (RTP_CLOCK_RATE / 1000);
+}
+
+uint32_t VideoRTPJPEGGetTimestamp(uint64_t uTimestamp) {
+    return uTimestamp * (RTP_CLOCK_RATE / 1000) / 1000;
+}
\ No newline at end of file
@@ -177,6 +177,15 @@ VideoRenderer* VideoRendererCreate(unsigned int sourceWidth, unsigned int source
     return videoRenderer;
 }
 
+void VideoRendererAttachThread(VideoRenderer* videoRenderer) {
+    glfwMakeContextCurrent(videoRenderer->window);
+}
+
+void VideoRendererDetachThread(VideoRenderer* videoRenderer) {
+    (void)videoRenderer;
+    glfwMakeContextCurrent(NULL);
+}
+
 void VideoRendererRender(VideoRenderer* videoRenderer, void* frame) {
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, videoRenderer->sourceWidth, videoRenderer->sourceHeight, GL_RGB, GL_UNSIGNED_BYTE, frame);
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -194,6 +203,7 @@ void VideoRendererRender(VideoRenderer* videoRenderer, void* frame) {
 }
 
 void VideoRendererFree(VideoRenderer* videoRenderer) {
+    glfwMakeContextCurrent(videoRenderer->window);
     glfwPollEvents();
     glfwDestroyWindow(videoRenderer->window);
     glDeleteVertexArrays(1, &videoRenderer->vertexArrayObject);
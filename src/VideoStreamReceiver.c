@@ -0,0 +1,140 @@
+#define _GNU_SOURCE
+#include "../include/VideoStreamReceiver.h"
+#include "../include/VideoStreamShared.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static void closeConnection(VideoStreamReceiver* videoStreamReceiver) {
+    close(videoStreamReceiver->fd);
+    videoStreamReceiver->fd = -1;
+    videoStreamReceiver->disconnectionCount++;
+}
+
+static bool receiveAll(VideoStreamReceiver* videoStreamReceiver, void* buffer, uint32_t length) {
+    uint32_t receivedLength = 0;
+    while (receivedLength < length) {
+        ssize_t bytesReceived = recv(videoStreamReceiver->fd, buffer + receivedLength, length - receivedLength, MSG_WAITALL);
+        if (bytesReceived < 0 && errno == EINTR && !videoStreamReceiver->closed) {
+            continue;
+        }
+        if (bytesReceived <= 0) {
+            return false;
+        }
+        receivedLength += bytesReceived;
+    }
+    videoStreamReceiver->receivedByteCount += length;
+    return true;
+}
+
+static void unlinkUnixSocket(VideoStreamReceiver* videoStreamReceiver) {
+    if (videoStreamReceiver->localAddress.ss_family != AF_UNIX) {
+        return;
+    }
+    struct sockaddr_un* unixAddress = (struct sockaddr_un*)&videoStreamReceiver->localAddress;
+    struct stat         status;
+    if (stat(unixAddress->sun_path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(unixAddress->sun_path);
+    }
+}
+
+VideoStreamReceiver* VideoStreamReceiverCreate(struct sockaddr_storage* localAddress, socklen_t localAddressLength, unsigned int maxJPEGLength) {
+    VideoStreamReceiver* videoStreamReceiver = malloc(sizeof(VideoStreamReceiver));
+    if (videoStreamReceiver == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoStreamReceiver.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoStreamReceiver, 0, sizeof(VideoStreamReceiver));
+    memcpy(&videoStreamReceiver->localAddress, localAddress, sizeof(struct sockaddr_storage));
+    videoStreamReceiver->localAddressLength = localAddressLength;
+    videoStreamReceiver->maxJPEGLength      = maxJPEGLength;
+    videoStreamReceiver->fd                 = -1;
+    videoStreamReceiver->listenFd           = socket(localAddress->ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (videoStreamReceiver->listenFd < 0) {
+        perror("Error: socket creation error");
+        exit(EXIT_FAILURE);
+    }
+    if (localAddress->ss_family == AF_INET) {
+        int reuseAddress = 1;
+        if (setsockopt(videoStreamReceiver->listenFd, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(int)) < 0) {
+            perror("Error: set socket options error");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        unlinkUnixSocket(videoStreamReceiver);
+    }
+    if (bind(videoStreamReceiver->listenFd, (struct sockaddr*)localAddress, localAddressLength) < 0) {
+        perror("Error: bind socket error");
+        exit(EXIT_FAILURE);
+    }
+    if (listen(videoStreamReceiver->listenFd, 1) < 0) {
+        perror("Error: listen socket error");
+        exit(EXIT_FAILURE);
+    }
+    return videoStreamReceiver;
+}
+
+VideoFrame* VideoStreamReceiverReceiveFrame(VideoStreamReceiver* videoStreamReceiver, VideoFramePool* videoFramePool) {
+    for (;;) {
+        if (videoStreamReceiver->closed) {
+            return NULL;
+        }
+        if (videoStreamReceiver->fd < 0) {
+            int fd = accept4(videoStreamReceiver->listenFd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (videoStreamReceiver->closed) {
+                    return NULL;
+                }
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                perror("Error: accept socket error");
+                exit(EXIT_FAILURE);
+            }
+            videoStreamReceiver->fd = fd;
+            videoStreamReceiver->connectionCount++;
+        }
+        if (!receiveAll(videoStreamReceiver, videoStreamReceiver->header, STREAM_HEADER_LENGTH)) {
+            closeConnection(videoStreamReceiver);
+            continue;
+        }
+        uint64_t uTimestamp;
+        uint32_t jpegLength;
+        VideoStreamSharedReadHeader(videoStreamReceiver->header, &uTimestamp, &jpegLength);
+        if (jpegLength == 0 || jpegLength > videoStreamReceiver->maxJPEGLength) {
+            videoStreamReceiver->invalidFrameCount++;
+            closeConnection(videoStreamReceiver);
+            continue;
+        }
+        VideoFrame* videoFrame = VideoFramePoolAcquire(videoFramePool);
+        if (!receiveAll(videoStreamReceiver, videoFrame->jpegBuffer, jpegLength)) {
+            VideoFrameRelease(videoFrame);
+            closeConnection(videoStreamReceiver);
+            continue;
+        }
+        videoFrame->jpegBufferLength = jpegLength;
+        videoFrame->uTimestamp       = uTimestamp;
+        videoStreamReceiver->receivedFrameCount++;
+        return videoFrame;
+    }
+}
+
+void VideoStreamReceiverClose(VideoStreamReceiver* videoStreamReceiver) {
+    videoStreamReceiver->closed = true;
+    shutdown(videoStreamReceiver->listenFd, SHUT_RDWR);
+    if (videoStreamReceiver->fd >= 0) {
+        shutdown(videoStreamReceiver->fd, SHUT_RDWR);
+    }
+}
+
+void VideoStreamReceiverFree(VideoStreamReceiver* videoStreamReceiver) {
+    if (videoStreamReceiver->fd >= 0) {
+        close(videoStreamReceiver->fd);
+    }
+    close(videoStreamReceiver->listenFd);
+    unlinkUnixSocket(videoStreamReceiver);
+    free(videoStreamReceiver);
+}
\ No newline at end of file
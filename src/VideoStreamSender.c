@@ -0,0 +1,143 @@
+#define _GNU_SOURCE
+#include "../include/VideoStreamSender.h"
+#include "../include/VideoStreamShared.h"
+#include "../include/VideoUDPShared.h"
+#include <errno.h>
+#include <linux/sockios.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static void closeConnection(VideoStreamSender* videoStreamSender) {
+    close(videoStreamSender->fd);
+    videoStreamSender->fd             = -1;
+    videoStreamSender->reconnectUTime = VideoUDPSharedGetEpochUSeconds() + VIDEO_STREAM_SENDER_RECONNECT_INTERVAL_USECONDS;
+    videoStreamSender->disconnectionCount++;
+}
+
+static bool openConnection(VideoStreamSender* videoStreamSender) {
+    if (VideoUDPSharedGetEpochUSeconds() < videoStreamSender->reconnectUTime) {
+        return false;
+    }
+    int fd = socket(videoStreamSender->remoteAddress.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("Error: socket creation error");
+        exit(EXIT_FAILURE);
+    }
+    struct timeval timeout;
+    timeout.tv_sec  = VIDEO_STREAM_SENDER_TIMEOUT_USECONDS / 1000000;
+    timeout.tv_usec = VIDEO_STREAM_SENDER_TIMEOUT_USECONDS % 1000000;
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0) {
+        perror("Error: set socket send timeout error");
+        exit(EXIT_FAILURE);
+    }
+    if (videoStreamSender->remoteAddress.ss_family == AF_INET) {
+        int noDelay = 1;
+        if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(int)) < 0) {
+            perror("Error: set TCP_NODELAY error");
+            exit(EXIT_FAILURE);
+        }
+        int notSentLowat = videoStreamSender->notSentLowat;
+        if (notSentLowat > 0 && setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &notSentLowat, sizeof(int)) < 0) {
+            perror("Error: set TCP_NOTSENT_LOWAT error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (connect(fd, (struct sockaddr*)&videoStreamSender->remoteAddress, videoStreamSender->remoteAddressLength) < 0) {
+        close(fd);
+        videoStreamSender->reconnectUTime = VideoUDPSharedGetEpochUSeconds() + VIDEO_STREAM_SENDER_RECONNECT_INTERVAL_USECONDS;
+        return false;
+    }
+    videoStreamSender->fd = fd;
+    videoStreamSender->connectionCount++;
+    return true;
+}
+
+static unsigned int getQueuedByteCount(VideoStreamSender* videoStreamSender) {
+    int queuedByteCount = 0;
+    int request         = videoStreamSender->remoteAddress.ss_family == AF_INET ? SIOCOUTQNSD : SIOCOUTQ;
+    if (ioctl(videoStreamSender->fd, request, &queuedByteCount) < 0 || queuedByteCount < 0) {
+        return 0;
+    }
+    return queuedByteCount;
+}
+
+VideoStreamSender* VideoStreamSenderCreate(struct sockaddr_storage* remoteAddress, socklen_t remoteAddressLength, unsigned int maxJPEGLength, unsigned int backlogLength, unsigned int notSentLowat) {
+    VideoStreamSender* videoStreamSender = malloc(sizeof(VideoStreamSender));
+    if (videoStreamSender == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoStreamSender.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoStreamSender, 0, sizeof(VideoStreamSender));
+    memcpy(&videoStreamSender->remoteAddress, remoteAddress, sizeof(struct sockaddr_storage));
+    videoStreamSender->remoteAddressLength = remoteAddressLength;
+    videoStreamSender->maxJPEGLength       = maxJPEGLength;
+    videoStreamSender->backlogLength       = backlogLength;
+    videoStreamSender->notSentLowat        = notSentLowat;
+    videoStreamSender->fd                  = -1;
+    openConnection(videoStreamSender);
+    return videoStreamSender;
+}
+
+void VideoStreamSenderSendFrame(VideoStreamSender* videoStreamSender, uint64_t uTimestamp, void* jpeg, unsigned int jpegLength) {
+    if (jpegLength == 0) {
+        fprintf(stderr, "Payload length was zero.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (jpegLength > videoStreamSender->maxJPEGLength) {
+        fprintf(stderr, "Payload length was greater than max jpeg length.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoStreamSender->fd < 0 && !openConnection(videoStreamSender)) {
+        videoStreamSender->unconnectedFrameCount++;
+        return;
+    }
+    videoStreamSender->queuedByteCount = getQueuedByteCount(videoStreamSender);
+    if (videoStreamSender->queuedByteCount > videoStreamSender->backlogLength) {
+        videoStreamSender->skippedFrameCount++;
+        return;
+    }
+    VideoStreamSharedWriteHeader(videoStreamSender->header, uTimestamp, jpegLength);
+    struct iovec iovecs[2];
+    iovecs[0].iov_base = videoStreamSender->header;
+    iovecs[0].iov_len  = STREAM_HEADER_LENGTH;
+    iovecs[1].iov_base = jpeg;
+    iovecs[1].iov_len  = jpegLength;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov    = iovecs;
+    message.msg_iovlen = 2;
+    while (message.msg_iovlen > 0) {
+        ssize_t bytesSent = sendmsg(videoStreamSender->fd, &message, MSG_NOSIGNAL);
+        if (bytesSent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            closeConnection(videoStreamSender);
+            return;
+        }
+        videoStreamSender->sentByteCount += bytesSent;
+        while (message.msg_iovlen > 0 && (size_t)bytesSent >= message.msg_iov->iov_len) {
+            bytesSent -= message.msg_iov->iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        if (message.msg_iovlen > 0) {
+            message.msg_iov->iov_base += bytesSent;
+            message.msg_iov->iov_len -= bytesSent;
+        }
+    }
+    videoStreamSender->sentFrameCount++;
+}
+
+void VideoStreamSenderFree(VideoStreamSender* videoStreamSender) {
+    if (videoStreamSender->fd >= 0) {
+        close(videoStreamSender->fd);
+    }
+    free(videoStreamSender);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "../include/VideoStreamShared.h"
+#include <arpa/inet.h>
+#include <endian.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/un.h>
+
+socklen_t VideoStreamSharedParseAddress(const char* address, struct sockaddr_storage* socketAddress) {
+    memset(socketAddress, 0, sizeof(struct sockaddr_storage));
+    if (strncmp(address, STREAM_UNIX_ADDRESS_PREFIX, strlen(STREAM_UNIX_ADDRESS_PREFIX)) == 0) {
+        struct sockaddr_un* unixAddress = (struct sockaddr_un*)socketAddress;
+        const char*         path        = address + strlen(STREAM_UNIX_ADDRESS_PREFIX);
+        if (path[0] == '\0' || strlen(path) >= sizeof(unixAddress->sun_path)) {
+            fprintf(stderr, "Invalid unix socket path: %s.\n", path);
+            exit(EXIT_FAILURE);
+        }
+        unixAddress->sun_family = AF_UNIX;
+        strcpy(unixAddress->sun_path, path);
+        return sizeof(struct sockaddr_un);
+    }
+    struct sockaddr_in* inetAddress = (struct sockaddr_in*)socketAddress;
+    const char*         portStart   = strrchr(address, ':');
+    size_t              ipLength    = portStart != NULL ? (size_t)(portStart - address) : 0;
+    char                ipAddress[INET_ADDRSTRLEN];
+    if (portStart == NULL || ipLength >= INET_ADDRSTRLEN || atoi(portStart + 1) <= 0 || atoi(portStart + 1) > UINT16_MAX) {
+        fprintf(stderr, "Invalid stream address: %s, expected IP_ADDRESS:PORT or unix:PATH.\n", address);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(ipAddress, address, ipLength);
+    ipAddress[ipLength]     = '\0';
+    inetAddress->sin_family = AF_INET;
+    inetAddress->sin_port   = htons(atoi(portStart + 1));
+    if (inet_pton(AF_INET, ipAddress, &inetAddress->sin_addr) != 1) {
+        fprintf(stderr, "Invalid stream address: %s, expected IP_ADDRESS:PORT or unix:PATH.\n", address);
+        exit(EXIT_FAILURE);
+    }
+    return sizeof(struct sockaddr_in);
+}
+
+void VideoStreamSharedWriteHeader(void* header, uint64_t uTimestamp, uint32_t length) {
+    uint64_t beUTimestamp = htobe64(uTimestamp);
+    uint32_t beLength     = htobe32(length);
+    memcpy(header + STREAM_HEADER_UTIMESTAMP_OFFSET, &beUTimestamp, STREAM_HEADER_UTIMESTAMP_SIZE);
+    memcpy(header + STREAM_HEADER_LENGTH_OFFSET, &beLength, STREAM_HEADER_LENGTH_SIZE);
+}
+
+void VideoStreamSharedReadHeader(const void* header, uint64_t* uTimestamp, uint32_t* length) {
+    uint64_t beUTimestamp;
+    uint32_t beLength;
+    memcpy(&beUTimestamp, header + STREAM_HEADER_UTIMESTAMP_OFFSET, STREAM_HEADER_UTIMESTAMP_SIZE);
+    memcpy(&beLength, header + STREAM_HEADER_LENGTH_OFFSET, STREAM_HEADER_LENGTH_SIZE);
+    *uTimestamp = be64toh(beUTimestamp);
+    *length     = be32toh(beLength);
+}
\ No newline at end of file
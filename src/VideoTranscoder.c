@@ -0,0 +1,59 @@
+#include "../include/VideoTranscoder.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <turbojpeg.h>
+
+VideoTranscoder* VideoTranscoderCreate(unsigned int width, unsigned int height) {
+    VideoTranscoder* videoTranscoder = malloc(sizeof(VideoTranscoder));
+    if (videoTranscoder == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoTranscoder.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoTranscoder, 0, sizeof(VideoTranscoder));
+    videoTranscoder->decompressHandle = tjInitDecompress();
+    videoTranscoder->compressHandle   = tjInitCompress();
+    if (!videoTranscoder->decompressHandle || !videoTranscoder->compressHandle) {
+        fprintf(stderr, "Failed to initialize TurboJPEG transcoder!\n");
+        exit(EXIT_FAILURE);
+    }
+    videoTranscoder->width              = width;
+    videoTranscoder->height             = height;
+    videoTranscoder->yuvBuffer          = tjAlloc(tjBufSizeYUV2(width, VIDEO_TRANSCODER_YUV_PAD, height, TJSAMP_444));
+    videoTranscoder->jpegBufferCapacity = tjBufSize(width, height, TJSAMP_444);
+    videoTranscoder->jpegBuffer         = tjAlloc(videoTranscoder->jpegBufferCapacity);
+    if (videoTranscoder->yuvBuffer == NULL || videoTranscoder->jpegBuffer == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoTranscoder buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    return videoTranscoder;
+}
+
+bool VideoTranscoderTranscodeFrame(VideoTranscoder* videoTranscoder, void* jpeg, unsigned int jpegLength, unsigned int quality) {
+    int width;
+    int height;
+    int subsampling;
+    int colorspace;
+    if (tjDecompressHeader3(videoTranscoder->decompressHandle, jpeg, jpegLength, &width, &height, &subsampling, &colorspace) < 0 || subsampling < 0 || (unsigned int)width != videoTranscoder->width || (unsigned int)height != videoTranscoder->height) {
+        return false;
+    }
+    if (tjDecompressToYUV2(videoTranscoder->decompressHandle, jpeg, jpegLength, videoTranscoder->yuvBuffer, width, VIDEO_TRANSCODER_YUV_PAD, height, 0) < 0 && tjGetErrorCode(videoTranscoder->decompressHandle) != TJERR_WARNING) {
+        return false;
+    }
+    unsigned char* transcodedJPEG       = videoTranscoder->jpegBuffer;
+    unsigned long  transcodedJPEGLength = videoTranscoder->jpegBufferCapacity;
+    if (tjCompressFromYUV(videoTranscoder->compressHandle, videoTranscoder->yuvBuffer, width, VIDEO_TRANSCODER_YUV_PAD, height, subsampling, &transcodedJPEG, &transcodedJPEGLength, quality, TJFLAG_NOREALLOC) < 0) {
+        return false;
+    }
+    videoTranscoder->jpegBufferLength = transcodedJPEGLength;
+    return true;
+}
+
+void VideoTranscoderFree(VideoTranscoder* videoTranscoder) {
+    tjFree(videoTranscoder->yuvBuffer);
+    tjFree(videoTranscoder->jpegBuffer);
+    tjDestroy(videoTranscoder->decompressHandle);
+    tjDestroy(videoTranscoder->compressHandle);
+    free(videoTranscoder);
+}
\ No newline at end of file
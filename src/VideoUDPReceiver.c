@@ -1,111 +1,1075 @@
+#define _GNU_SOURCE
 #include "../include/VideoUDPReceiver.h"
 #include "../include/VideoUDPShared.h"
+#include <arpa/inet.h>
 #include <endian.h>
 #include <errno.h>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/select.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
-VideoUDPReceiver* VideoUDPReceiverCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress) {
+static inline void* getScratchBody(VideoUDPReceiver* videoUDPReceiver, unsigned int messageIndex) {
+    return videoUDPReceiver->packets + messageIndex * videoUDPReceiver->maxPacketLength + HEADER_LENGTH;
+}
+
+static void evictPacketBody(VideoUDPReceiver* videoUDPReceiver, unsigned int messageIndex) {
+    if (videoUDPReceiver->gro || videoUDPReceiver->rtp) {
+        return;
+    }
+    struct iovec* bodyIovec   = &videoUDPReceiver->iovecs[messageIndex * 2 + 1];
+    void*         scratchBody = getScratchBody(videoUDPReceiver, messageIndex);
+    if (bodyIovec->iov_base == scratchBody) {
+        return;
+    }
+    unsigned int messageLength = videoUDPReceiver->messages[messageIndex].msg_len;
+    if (messageLength > HEADER_LENGTH) {
+        memcpy(scratchBody, bodyIovec->iov_base, messageLength - HEADER_LENGTH);
+    }
+    bodyIovec->iov_base = scratchBody;
+}
+
+static unsigned int getSegmentLength(VideoUDPReceiver* videoUDPReceiver, unsigned int messageIndex) {
+    struct msghdr* message = &videoUDPReceiver->messages[messageIndex].msg_hdr;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(message); cmsg != NULL; cmsg = CMSG_NXTHDR(message, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segmentLength;
+            memcpy(&segmentLength, CMSG_DATA(cmsg), sizeof(int));
+            return segmentLength;
+        }
+    }
+    return videoUDPReceiver->messages[messageIndex].msg_len;
+}
+
+static void prepareSegmentControls(VideoUDPReceiver* videoUDPReceiver) {
+    for (unsigned int messageIndex = 0; messageIndex < videoUDPReceiver->batchCapacity; messageIndex++) {
+        videoUDPReceiver->messages[messageIndex].msg_hdr.msg_control    = videoUDPReceiver->controls + messageIndex * CMSG_SPACE(sizeof(int));
+        videoUDPReceiver->messages[messageIndex].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(int));
+    }
+}
+
+static void predictPacketBodies(VideoUDPReceiver* videoUDPReceiver) {
+    VideoUDPReceiverAssembly* assembly        = videoUDPReceiver->currentAssembly;
+    VideoFrame*               videoFrame      = assembly != NULL ? assembly->videoFrame : videoUDPReceiver->spareFrame;
+    uint32_t                  nextPacketIndex = assembly != NULL ? assembly->nextPacketIndex : 0;
+    for (unsigned int messageIndex = 0; messageIndex < VIDEO_UDP_RECEIVER_BATCH_LENGTH; messageIndex++) {
+        uint32_t packetIndex = nextPacketIndex + messageIndex;
+        void*    body        = getScratchBody(videoUDPReceiver, messageIndex);
+        if (packetIndex < videoUDPReceiver->maxSlotsPerJPEG && (assembly == NULL || !assembly->flags[packetIndex])) {
+            body = videoFrame->jpegBuffer + packetIndex * videoUDPReceiver->maxPacketBodyLength;
+        }
+        videoUDPReceiver->iovecs[messageIndex * 2 + 1].iov_base = body;
+    }
+}
+
+static void evictPendingBodies(VideoUDPReceiver* videoUDPReceiver) {
+    for (unsigned int pendingIndex = videoUDPReceiver->batchOffset; pendingIndex < videoUDPReceiver->batchLength; pendingIndex++) {
+        evictPacketBody(videoUDPReceiver, pendingIndex);
+    }
+}
+
+static void claimPacketBody(VideoUDPReceiver* videoUDPReceiver, void* packetBody) {
+    for (unsigned int pendingIndex = videoUDPReceiver->batchOffset; pendingIndex < videoUDPReceiver->batchLength; pendingIndex++) {
+        if (videoUDPReceiver->iovecs[pendingIndex * 2 + 1].iov_base == packetBody) {
+            evictPacketBody(videoUDPReceiver, pendingIndex);
+        }
+    }
+}
+
+static bool recoverPacket(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly, uint32_t parityPacketCount, uint32_t parityIndex, uint32_t* recoveredPacketIndex) {
+    uint32_t    packetCount = assembly->packetCount;
+    VideoFrame* videoFrame  = assembly->videoFrame;
+    if (!assembly->flags[packetCount + parityIndex]) {
+        return false;
+    }
+    uint32_t missingPacketIndex = packetCount;
+    for (uint32_t packetIndex = parityIndex; packetIndex < packetCount; packetIndex += parityPacketCount) {
+        if (assembly->flags[packetIndex]) {
+            continue;
+        }
+        if (missingPacketIndex != packetCount) {
+            return false;
+        }
+        missingPacketIndex = packetIndex;
+    }
+    if (missingPacketIndex == packetCount) {
+        return false;
+    }
+    uint32_t missingBodyLength = assembly->bodyLengths[packetCount + parityIndex];
+    for (uint32_t packetIndex = parityIndex; packetIndex < packetCount; packetIndex += parityPacketCount) {
+        if (packetIndex != missingPacketIndex) {
+            missingBodyLength ^= assembly->bodyLengths[packetIndex];
+        }
+    }
+    if (missingBodyLength > videoUDPReceiver->maxPacketBodyLength || (videoUDPReceiver->restart && missingBodyLength < RESTART_PREFIX_LENGTH)) {
+        return false;
+    }
+    void* missingBody = videoFrame->jpegBuffer + missingPacketIndex * videoUDPReceiver->maxPacketBodyLength;
+    claimPacketBody(videoUDPReceiver, missingBody);
+    memcpy(missingBody, videoFrame->jpegBuffer + (packetCount + parityIndex) * videoUDPReceiver->maxPacketBodyLength, videoUDPReceiver->maxPacketBodyLength);
+    for (uint32_t packetIndex = parityIndex; packetIndex < packetCount; packetIndex += parityPacketCount) {
+        if (packetIndex != missingPacketIndex) {
+            VideoUDPSharedXOR(missingBody, videoFrame->jpegBuffer + packetIndex * videoUDPReceiver->maxPacketBodyLength, assembly->bodyLengths[packetIndex]);
+        }
+    }
+    assembly->bodyLengths[missingPacketIndex] = missingBodyLength;
+    *recoveredPacketIndex                     = missingPacketIndex;
+    return true;
+}
+
+static uint64_t getMonotonicUSeconds() {
+    struct timespec monotonicTime;
+    clock_gettime(CLOCK_MONOTONIC, &monotonicTime);
+    return (uint64_t)monotonicTime.tv_sec * 1000000 + monotonicTime.tv_nsec / 1000;
+}
+
+static bool awaitPackets(VideoUDPReceiver* videoUDPReceiver, uint64_t uDeadline) {
+    for (;;) {
+        uint64_t uNow = getMonotonicUSeconds();
+        if (uNow >= uDeadline) {
+            return false;
+        }
+        struct pollfd pollDescriptor;
+        pollDescriptor.fd     = videoUDPReceiver->fd;
+        pollDescriptor.events = POLLIN;
+        int ready             = poll(&pollDescriptor, 1, (uDeadline - uNow + 999) / 1000);
+        if (ready > 0 || videoUDPReceiver->fd < 0 || (ready < 0 && errno == EINTR)) {
+            return true;
+        }
+        if (ready < 0) {
+            perror("Socket error.");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void sendNack(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly) {
+    uint32_t maxMissingCount = videoUDPReceiver->maxPacketBodyLength / sizeof(uint32_t);
+    uint32_t missingCount    = 0;
+    void*    missingIndices  = videoUDPReceiver->nackPacket + PACKET_BODY_START_OFFSET;
+    for (uint32_t packetIndex = 0; packetIndex < assembly->packetCount && missingCount < maxMissingCount; packetIndex++) {
+        if (assembly->flags[packetIndex]) {
+            continue;
+        }
+        uint32_t bePacketIndex = htonl(packetIndex);
+        memcpy(missingIndices + missingCount * sizeof(uint32_t), &bePacketIndex, sizeof(uint32_t));
+        missingCount++;
+    }
+    if (missingCount == 0) {
+        return;
+    }
+    VideoUDPSharedWriteHeader(videoUDPReceiver->nackPacket, videoUDPReceiver->streamId, assembly->sequence, assembly->uTimestamp, CONTROL_TYPE_NACK, CONTROL_PACKET_COUNT, missingCount * sizeof(uint32_t));
+    ssize_t bytesSent = sendto(videoUDPReceiver->fd, videoUDPReceiver->nackPacket, HEADER_LENGTH + missingCount * sizeof(uint32_t), 0, (struct sockaddr*)&assembly->senderAddress, sizeof(struct sockaddr_in));
+    if (bytesSent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EBADF && errno != ECONNREFUSED && errno != EINTR) {
+        perror("Socket error.");
+        exit(EXIT_FAILURE);
+    }
+    if (bytesSent >= 0) {
+        videoUDPReceiver->nackSentCount++;
+    }
+}
+
+static void sendDueNacks(VideoUDPReceiver* videoUDPReceiver) {
+    uint64_t uNow = getMonotonicUSeconds();
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* assembly = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (!assembly->active || assembly->nackRounds >= VIDEO_UDP_RECEIVER_MAX_NACK_ROUNDS || assembly->nackUDeadline > uNow) {
+            continue;
+        }
+        sendNack(videoUDPReceiver, assembly);
+        assembly->nackRounds++;
+        assembly->nackUDeadline = uNow + videoUDPReceiver->nackDeadlineUSeconds;
+    }
+}
+
+static void sendDueReport(VideoUDPReceiver* videoUDPReceiver) {
+    uint64_t uNow = getMonotonicUSeconds();
+    if (!videoUDPReceiver->hasReportAddress || videoUDPReceiver->reportUDeadline > uNow) {
+        return;
+    }
+    uint64_t lostCount           = videoUDPReceiver->incompleteFrameCount - videoUDPReceiver->reportedIncompleteCount;
+    uint64_t uSeconds            = uNow - videoUDPReceiver->lastReportUTime;
+    uint64_t expectedPacketCount = videoUDPReceiver->expectedPacketCount - videoUDPReceiver->reportedExpectedPacketCount;
+    uint64_t lostPacketCount     = expectedPacketCount - (videoUDPReceiver->receivedPacketCount - videoUDPReceiver->reportedReceivedPacketCount);
+    char     report[HEADER_LENGTH + REPORT_LENGTH];
+    VideoUDPSharedWriteHeader(report, videoUDPReceiver->streamId, 0, videoUDPReceiver->lastUTimestamp, CONTROL_TYPE_REPORT, CONTROL_PACKET_COUNT, REPORT_LENGTH);
+    VideoUDPSharedWriteReport(report + PACKET_BODY_START_OFFSET, VideoUDPSharedGetEpochUSeconds(), videoUDPReceiver->deliveredFrameCount - videoUDPReceiver->reportedDeliveredCount, lostCount, videoUDPReceiver->lateFrameCount - videoUDPReceiver->reportedLateCount, videoUDPReceiver->receivedByteCount - videoUDPReceiver->reportedByteCount, uSeconds < UINT32_MAX ? uSeconds : UINT32_MAX, expectedPacketCount, lostPacketCount, videoUDPReceiver->jitterUSeconds < UINT32_MAX ? videoUDPReceiver->jitterUSeconds : UINT32_MAX, videoUDPReceiver->roundTripUSeconds < UINT32_MAX ? videoUDPReceiver->roundTripUSeconds : UINT32_MAX, atomic_load(&videoUDPReceiver->clockOffsetUSeconds));
+    ssize_t bytesSent = sendto(videoUDPReceiver->fd, report, sizeof(report), 0, (struct sockaddr*)&videoUDPReceiver->reportAddress, sizeof(struct sockaddr_in));
+    if (bytesSent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EBADF && errno != ECONNREFUSED && errno != EINTR) {
+        perror("Socket error.");
+        exit(EXIT_FAILURE);
+    }
+    if (bytesSent >= 0) {
+        videoUDPReceiver->reportSentCount++;
+    }
+    videoUDPReceiver->reportedDeliveredCount      = videoUDPReceiver->deliveredFrameCount;
+    videoUDPReceiver->reportedIncompleteCount     = videoUDPReceiver->incompleteFrameCount;
+    videoUDPReceiver->reportedLateCount           = videoUDPReceiver->lateFrameCount;
+    videoUDPReceiver->reportedByteCount           = videoUDPReceiver->receivedByteCount;
+    videoUDPReceiver->reportedExpectedPacketCount = videoUDPReceiver->expectedPacketCount;
+    videoUDPReceiver->reportedReceivedPacketCount = videoUDPReceiver->receivedPacketCount;
+    videoUDPReceiver->lastReportUTime             = uNow;
+    videoUDPReceiver->reportUDeadline             = uNow + videoUDPReceiver->reportIntervalUSeconds;
+}
+
+static void readReply(VideoUDPReceiver* videoUDPReceiver, const void* reply) {
+    uint64_t uNow = VideoUDPSharedGetEpochUSeconds();
+    uint64_t echoUTime;
+    uint64_t receiveUTime;
+    uint64_t sendUTime;
+    VideoUDPSharedReadReply(reply, &echoUTime, &receiveUTime, &sendUTime, &videoUDPReceiver->senderPacketCount, &videoUDPReceiver->senderFrameCount);
+    if (echoUTime == 0 || echoUTime > uNow || sendUTime < receiveUTime) {
+        return;
+    }
+    int64_t roundTrip   = (int64_t)(uNow - echoUTime) - (int64_t)(sendUTime - receiveUTime);
+    int64_t clockOffset = ((int64_t)(receiveUTime - echoUTime) + (int64_t)(sendUTime - uNow)) / 2;
+    roundTrip           = roundTrip > 0 ? roundTrip : 0;
+    if (videoUDPReceiver->replyReceivedCount == 0) {
+        videoUDPReceiver->roundTripUSeconds = roundTrip;
+        atomic_store(&videoUDPReceiver->clockOffsetUSeconds, clockOffset);
+    } else {
+        if ((uint64_t)roundTrip <= videoUDPReceiver->roundTripUSeconds) {
+            int64_t smoothedClockOffset = atomic_load(&videoUDPReceiver->clockOffsetUSeconds);
+            atomic_store(&videoUDPReceiver->clockOffsetUSeconds, smoothedClockOffset + (clockOffset - smoothedClockOffset) / VIDEO_UDP_RECEIVER_ROUND_TRIP_GAIN);
+        }
+        videoUDPReceiver->roundTripUSeconds = (videoUDPReceiver->roundTripUSeconds * (VIDEO_UDP_RECEIVER_ROUND_TRIP_GAIN - 1) + roundTrip) / VIDEO_UDP_RECEIVER_ROUND_TRIP_GAIN;
+    }
+    videoUDPReceiver->replyReceivedCount++;
+}
+
+static void updateJitter(VideoUDPReceiver* videoUDPReceiver, uint64_t uTimestamp) {
+    int64_t transit = (int64_t)(VideoUDPSharedGetEpochUSeconds() - uTimestamp);
+    if (videoUDPReceiver->hasTransit) {
+        int64_t transitDelta = transit - videoUDPReceiver->lastTransit;
+        if (transitDelta < 0) {
+            transitDelta = -transitDelta;
+        }
+        videoUDPReceiver->jitterUSeconds = (videoUDPReceiver->jitterUSeconds * (VIDEO_UDP_RECEIVER_JITTER_GAIN - 1) + transitDelta) / VIDEO_UDP_RECEIVER_JITTER_GAIN;
+    }
+    videoUDPReceiver->hasTransit  = true;
+    videoUDPReceiver->lastTransit = transit;
+}
+
+static void updateOneWayDelay(VideoUDPReceiver* videoUDPReceiver, uint64_t uTimestamp) {
+    if (videoUDPReceiver->replyReceivedCount == 0) {
+        return;
+    }
+    int64_t oneWayDelay = (int64_t)(VideoUDPSharedGetEpochUSeconds() - uTimestamp) + atomic_load(&videoUDPReceiver->clockOffsetUSeconds);
+    oneWayDelay         = oneWayDelay > 0 ? oneWayDelay : 0;
+    if (videoUDPReceiver->oneWayDelayUSeconds == 0) {
+        videoUDPReceiver->oneWayDelayUSeconds = oneWayDelay;
+    } else {
+        videoUDPReceiver->oneWayDelayUSeconds = (videoUDPReceiver->oneWayDelayUSeconds * (VIDEO_UDP_RECEIVER_JITTER_GAIN - 1) + oneWayDelay) / VIDEO_UDP_RECEIVER_JITTER_GAIN;
+    }
+}
+
+static void countMissingFrames(VideoUDPReceiver* videoUDPReceiver, uint16_t sequence) {
+    int16_t sequenceDelta = (int16_t)(sequence - videoUDPReceiver->lastSequence);
+    if (!videoUDPReceiver->hasSequence) {
+        sequenceDelta = 1;
+    }
+    if (sequenceDelta > 1) {
+        videoUDPReceiver->missingFrameCount += sequenceDelta - 1;
+        videoUDPReceiver->incompleteFrameCount += sequenceDelta - 1;
+    }
+    if (sequenceDelta > 0) {
+        videoUDPReceiver->hasSequence  = true;
+        videoUDPReceiver->lastSequence = sequence;
+    }
+}
+
+static void checkDescriptor(VideoUDPReceiver* videoUDPReceiver, const void* descriptor, bool configure) {
+    uint32_t maxPacketLength;
+    uint32_t maxJPEGLength;
+    uint32_t width;
+    uint32_t height;
+    uint32_t timebaseNumerator;
+    uint32_t timebaseDenominator;
+    uint32_t fecPercent;
+    bool     restart;
+    VideoUDPSharedReadDescriptor(descriptor, &maxPacketLength, &maxJPEGLength, &width, &height, &timebaseNumerator, &timebaseDenominator, &fecPercent, &restart);
+    if (configure) {
+        videoUDPReceiver->maxPacketLength     = videoUDPReceiver->maxPacketLength > 0 ? videoUDPReceiver->maxPacketLength : maxPacketLength;
+        videoUDPReceiver->maxJPEGLength       = videoUDPReceiver->maxJPEGLength > 0 ? videoUDPReceiver->maxJPEGLength : maxJPEGLength;
+        videoUDPReceiver->width               = videoUDPReceiver->width > 0 ? videoUDPReceiver->width : width;
+        videoUDPReceiver->height              = videoUDPReceiver->height > 0 ? videoUDPReceiver->height : height;
+        videoUDPReceiver->timebaseNumerator   = videoUDPReceiver->timebaseNumerator > 0 ? videoUDPReceiver->timebaseNumerator : timebaseNumerator;
+        videoUDPReceiver->timebaseDenominator = videoUDPReceiver->timebaseDenominator > 0 ? videoUDPReceiver->timebaseDenominator : timebaseDenominator;
+        videoUDPReceiver->fecPercent          = videoUDPReceiver->fecPercent > 0 ? videoUDPReceiver->fecPercent : fecPercent;
+    }
+    if (videoUDPReceiver->maxPacketLength != maxPacketLength || videoUDPReceiver->maxJPEGLength < maxJPEGLength || videoUDPReceiver->width != width || videoUDPReceiver->height != height || videoUDPReceiver->timebaseNumerator != timebaseNumerator || videoUDPReceiver->timebaseDenominator != timebaseDenominator || videoUDPReceiver->fecPercent != fecPercent || videoUDPReceiver->restart != restart) {
+        fprintf(stderr, "Error: Stream %u is sent with max packet length %u, max JPEG length %u, resolution %ux%u, timebase %u/%u, fec %u and restart %s, which this receive does not match.\n", videoUDPReceiver->streamId, maxPacketLength, maxJPEGLength, width, height, timebaseNumerator, timebaseDenominator, fecPercent, restart ? "true" : "false");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPReceiver->descriptorReceivedCount++;
+}
+
+static void awaitDescriptor(VideoUDPReceiver* videoUDPReceiver) {
+    void* packet = malloc(VIDEO_UDP_RECEIVER_GRO_BUFFER_LENGTH);
+    if (packet == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver descriptor packet.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (;;) {
+        ssize_t bytesReceived = recv(videoUDPReceiver->fd, packet, VIDEO_UDP_RECEIVER_GRO_BUFFER_LENGTH, 0);
+        if (bytesReceived < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesReceived < 0) {
+            perror("Socket error.");
+            exit(EXIT_FAILURE);
+        }
+        if (bytesReceived != HEADER_LENGTH + DESCRIPTOR_LENGTH) {
+            continue;
+        }
+        uint8_t  streamId;
+        uint16_t sequence;
+        uint64_t uTimestamp;
+        uint32_t packetIndex;
+        uint32_t packetCount;
+        uint32_t packetBodyLength;
+        bool     supported = VideoUDPSharedReadHeader(packet, &streamId, &sequence, &uTimestamp, &packetIndex, &packetCount, &packetBodyLength);
+        if (supported && streamId == videoUDPReceiver->streamId && packetCount == CONTROL_PACKET_COUNT && packetIndex == CONTROL_TYPE_DESCRIPTOR && packetBodyLength == DESCRIPTOR_LENGTH) {
+            checkDescriptor(videoUDPReceiver, packet + PACKET_BODY_START_OFFSET, true);
+            break;
+        }
+    }
+    free(packet);
+}
+
+static void countAssemblyPackets(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly) {
+    if (videoUDPReceiver->rtp) {
+        return;
+    }
+    videoUDPReceiver->expectedPacketCount += assembly->packetCount;
+    videoUDPReceiver->receivedPacketCount += assembly->packetsReceived;
+}
+
+static bool getNextUDeadline(VideoUDPReceiver* videoUDPReceiver, uint64_t* uDeadline) {
+    bool found = false;
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* assembly = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (!assembly->active) {
+            continue;
+        }
+        if (videoUDPReceiver->nackDeadlineUSeconds > 0 && assembly->nackRounds < VIDEO_UDP_RECEIVER_MAX_NACK_ROUNDS && (!found || assembly->nackUDeadline < *uDeadline)) {
+            *uDeadline = assembly->nackUDeadline;
+            found      = true;
+        }
+        if (videoUDPReceiver->restart && (!found || assembly->partialUDeadline < *uDeadline)) {
+            *uDeadline = assembly->partialUDeadline;
+            found      = true;
+        }
+    }
+    if (videoUDPReceiver->hasReportAddress && (!found || videoUDPReceiver->reportUDeadline < *uDeadline)) {
+        *uDeadline = videoUDPReceiver->reportUDeadline;
+        found      = true;
+    }
+    return found;
+}
+
+static void closeAssembly(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly) {
+    evictPendingBodies(videoUDPReceiver);
+    countAssemblyPackets(videoUDPReceiver, assembly);
+    VideoFrameRelease(assembly->videoFrame);
+    assembly->videoFrame = NULL;
+    assembly->active     = false;
+    if (videoUDPReceiver->currentAssembly == assembly) {
+        videoUDPReceiver->currentAssembly = NULL;
+    }
+}
+
+static void closeAssembliesBefore(VideoUDPReceiver* videoUDPReceiver, uint64_t uTimestamp) {
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* assembly = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (assembly->active && assembly->uTimestamp < uTimestamp) {
+            closeAssembly(videoUDPReceiver, assembly);
+            videoUDPReceiver->incompleteFrameCount++;
+        }
+    }
+}
+
+static VideoUDPReceiverAssembly* findAssembly(VideoUDPReceiver* videoUDPReceiver, uint64_t uTimestamp) {
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* assembly = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (assembly->active && assembly->uTimestamp == uTimestamp) {
+            return assembly;
+        }
+    }
+    return NULL;
+}
+
+static VideoUDPReceiverAssembly* openAssembly(VideoUDPReceiver* videoUDPReceiver, VideoFramePool* videoFramePool, uint16_t sequence, uint64_t uTimestamp, uint32_t packetCount, unsigned int messageIndex) {
+    VideoUDPReceiverAssembly* assembly = NULL;
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* candidate = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (!candidate->active) {
+            assembly = candidate;
+            break;
+        }
+        if (assembly == NULL || candidate->uTimestamp < assembly->uTimestamp) {
+            assembly = candidate;
+        }
+    }
+    if (assembly->active) {
+        if (assembly->uTimestamp > uTimestamp) {
+            return NULL;
+        }
+        closeAssembly(videoUDPReceiver, assembly);
+        videoUDPReceiver->incompleteFrameCount++;
+    }
+    if (videoUDPReceiver->spareFrame != NULL) {
+        assembly->videoFrame         = videoUDPReceiver->spareFrame;
+        videoUDPReceiver->spareFrame = NULL;
+    } else {
+        assembly->videoFrame = VideoFramePoolAcquire(videoFramePool);
+    }
+    uint64_t uNow               = getMonotonicUSeconds();
+    assembly->active            = true;
+    assembly->sequence          = sequence;
+    assembly->uTimestamp        = uTimestamp;
+    assembly->packetCount       = packetCount;
+    assembly->packetsFlagged    = 0;
+    assembly->packetsReceived   = 0;
+    assembly->nextPacketIndex   = 0;
+    assembly->nackRounds        = 0;
+    assembly->nackUDeadline     = uNow + videoUDPReceiver->nackDeadlineUSeconds;
+    assembly->partialUDeadline  = uNow + videoUDPReceiver->restartDeadlineUSeconds;
+    assembly->openUTime         = uNow;
+    assembly->rtpHeadersLength  = 0;
+    assembly->rtpScanLength     = 0;
+    assembly->rtpReceivedLength = 0;
+    memset(assembly->flags, 0, videoUDPReceiver->maxSlotsPerJPEG * sizeof(bool));
+    if (videoUDPReceiver->nackDeadlineUSeconds > 0) {
+        assembly->senderAddress = videoUDPReceiver->senderAddresses[messageIndex];
+    }
+    if (videoUDPReceiver->reportIntervalUSeconds > 0) {
+        videoUDPReceiver->reportAddress    = videoUDPReceiver->senderAddresses[messageIndex];
+        videoUDPReceiver->hasReportAddress = true;
+    }
+    updateJitter(videoUDPReceiver, uTimestamp);
+    if (!videoUDPReceiver->rtp) {
+        countMissingFrames(videoUDPReceiver, sequence);
+    }
+    return assembly;
+}
+
+static void writeRestartMarker(void* jpeg, uint32_t* jpegLength, uint8_t markerCode) {
+    uint8_t marker[2] = {0xFF, markerCode};
+    memcpy(jpeg + *jpegLength, marker, sizeof(marker));
+    *jpegLength += sizeof(marker);
+}
+
+static uint32_t assembleRestartFrame(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly) {
+    void*    jpeg            = assembly->videoFrame->jpegBuffer;
+    uint32_t jpegLength      = 0;
+    uint32_t nextInterval    = 0;
+    bool     previousWritten = false;
+    for (uint32_t packetIndex = 0; packetIndex < assembly->packetCount; packetIndex++) {
+        if (!assembly->flags[packetIndex]) {
+            previousWritten = false;
+            continue;
+        }
+        void*    body = jpeg + packetIndex * videoUDPReceiver->maxPacketBodyLength;
+        uint32_t firstInterval;
+        uint16_t markerCount;
+        bool     boundary;
+        VideoUDPSharedReadRestartPrefix(body, &firstInterval, &markerCount, &boundary);
+        uint8_t* data       = body + RESTART_PREFIX_LENGTH;
+        uint32_t dataStart  = 0;
+        uint32_t dataLength = assembly->bodyLengths[packetIndex] - RESTART_PREFIX_LENGTH;
+        if (!boundary && !previousWritten) {
+            uint32_t markerEnd = VideoUDPSharedFindRestartMarkerEnd(data, 0, dataLength);
+            if (markerEnd == 0) {
+                continue;
+            }
+            dataStart = markerEnd - 2;
+        }
+        if (boundary || !previousWritten) {
+            for (; nextInterval < firstInterval; nextInterval++) {
+                writeRestartMarker(jpeg, &jpegLength, 0xD0 + (nextInterval & 7));
+            }
+        }
+        memmove(jpeg + jpegLength, data + dataStart, dataLength - dataStart);
+        jpegLength += dataLength - dataStart;
+        nextInterval    = firstInterval + markerCount;
+        previousWritten = true;
+    }
+    if (!assembly->flags[assembly->packetCount - 1]) {
+        writeRestartMarker(jpeg, &jpegLength, 0xD9);
+    }
+    return jpegLength;
+}
+
+static VideoFrame* finishAssembly(VideoUDPReceiver* videoUDPReceiver, VideoUDPReceiverAssembly* assembly) {
+    VideoFrame* videoFrame = assembly->videoFrame;
+    evictPendingBodies(videoUDPReceiver);
+    countAssemblyPackets(videoUDPReceiver, assembly);
+    if (videoUDPReceiver->restart) {
+        videoFrame->jpegBufferLength = assembleRestartFrame(videoUDPReceiver, assembly);
+    } else if (videoUDPReceiver->rtp) {
+        uint8_t eoi[RTP_JPEG_EOI_LENGTH] = {0xFF, 0xD9};
+        videoFrame->jpegBufferLength     = assembly->rtpHeadersLength + assembly->rtpScanLength + RTP_JPEG_EOI_LENGTH;
+        memcpy(videoFrame->jpegBuffer + assembly->rtpHeadersLength + assembly->rtpScanLength, eoi, RTP_JPEG_EOI_LENGTH);
+    } else {
+        videoFrame->jpegBufferLength = (assembly->packetCount - 1) * videoUDPReceiver->maxPacketBodyLength + assembly->bodyLengths[assembly->packetCount - 1];
+    }
+    videoFrame->uTimestamp           = assembly->uTimestamp;
+    videoUDPReceiver->lastUTimestamp = assembly->uTimestamp;
+    videoUDPReceiver->deliveredFrameCount++;
+    if (videoUDPReceiver->frameIntervalUSeconds > 0 && getMonotonicUSeconds() - assembly->openUTime > videoUDPReceiver->frameIntervalUSeconds) {
+        videoUDPReceiver->lateFrameCount++;
+    }
+    updateOneWayDelay(videoUDPReceiver, assembly->uTimestamp);
+    assembly->videoFrame             = NULL;
+    assembly->active                 = false;
+    if (videoUDPReceiver->currentAssembly == assembly) {
+        videoUDPReceiver->currentAssembly = NULL;
+    }
+    closeAssembliesBefore(videoUDPReceiver, videoFrame->uTimestamp);
+    return videoFrame;
+}
+
+static bool isStaleUTimestamp(VideoUDPReceiver* videoUDPReceiver, uint64_t uTimestamp) {
+    if (videoUDPReceiver->lastUTimestamp == 0 || uTimestamp > videoUDPReceiver->lastUTimestamp) {
+        return false;
+    }
+    if (videoUDPReceiver->lastUTimestamp - uTimestamp <= VIDEO_UDP_RECEIVER_MAX_REORDER_USECONDS) {
+        return true;
+    }
+    closeAssembliesBefore(videoUDPReceiver, UINT64_MAX);
+    videoUDPReceiver->lastUTimestamp = 0;
+    videoUDPReceiver->hasSequence    = false;
+    return false;
+}
+
+static const uint8_t* readRTPQuantizationTables(VideoUDPReceiver* videoUDPReceiver, uint8_t quality, const uint8_t* payload, uint32_t payloadLength, uint32_t* headerLength) {
+    if (quality < RTP_JPEG_MIN_DYNAMIC_QUALITY) {
+        return quality <= RTP_JPEG_MAX_QUALITY ? videoUDPReceiver->rtpQuantizationTables : NULL;
+    }
+    if (payloadLength < *headerLength + RTP_JPEG_QUANTIZATION_HEADER_LENGTH) {
+        return NULL;
+    }
+    uint8_t  precision;
+    uint32_t quantizationTablesLength;
+    VideoRTPJPEGReadQuantizationHeader(payload + *headerLength, &precision, &quantizationTablesLength);
+    *headerLength += RTP_JPEG_QUANTIZATION_HEADER_LENGTH;
+    if (quantizationTablesLength == 0) {
+        return videoUDPReceiver->rtpQuality == quality ? videoUDPReceiver->rtpQuantizationTables : NULL;
+    }
+    if (precision != 0 || quantizationTablesLength != RTP_JPEG_QUANTIZATION_TABLES_LENGTH || payloadLength < *headerLength + quantizationTablesLength) {
+        return NULL;
+    }
+    const uint8_t* quantizationTables = payload + *headerLength;
+    *headerLength += quantizationTablesLength;
+    return quantizationTables;
+}
+
+static VideoUDPReceiverAssembly* readRTPPacket(VideoUDPReceiver* videoUDPReceiver, VideoFramePool* videoFramePool, const uint8_t* packet, uint32_t packetLength, unsigned int messageIndex) {
+    bool     marker;
+    uint16_t sequence;
+    uint32_t timestamp;
+    uint32_t ssrc;
+    uint32_t payloadOffset;
+    uint32_t payloadLength;
+    if (!VideoRTPJPEGReadRTPHeader(packet, packetLength, &marker, &sequence, &timestamp, &ssrc, &payloadOffset, &payloadLength) || payloadLength < RTP_JPEG_HEADER_LENGTH) {
+        videoUDPReceiver->unsupportedPacketCount++;
+        return NULL;
+    }
+    const uint8_t* payload = packet + payloadOffset;
+    uint32_t       fragmentOffset;
+    uint8_t        type;
+    uint8_t        quality;
+    uint32_t       width;
+    uint32_t       height;
+    uint32_t       restartInterval = 0;
+    uint32_t       headerLength    = RTP_JPEG_HEADER_LENGTH;
+    VideoRTPJPEGReadJPEGHeader(payload, &fragmentOffset, &type, &quality, &width, &height);
+    if ((type & ~RTP_JPEG_TYPE_RESTART) > RTP_JPEG_TYPE_420 || ((type & RTP_JPEG_TYPE_RESTART) && payloadLength < headerLength + RTP_JPEG_RESTART_HEADER_LENGTH)) {
+        videoUDPReceiver->unsupportedPacketCount++;
+        return NULL;
+    }
+    if (type & RTP_JPEG_TYPE_RESTART) {
+        restartInterval = VideoRTPJPEGReadRestartHeader(payload + headerLength);
+        headerLength += RTP_JPEG_RESTART_HEADER_LENGTH;
+    }
+    const uint8_t* quantizationTables = NULL;
+    if (fragmentOffset == 0) {
+        quantizationTables = readRTPQuantizationTables(videoUDPReceiver, quality, payload, payloadLength, &headerLength);
+        if (quantizationTables == NULL) {
+            videoUDPReceiver->unsupportedPacketCount++;
+            return NULL;
+        }
+    }
+    if (width != videoUDPReceiver->width || height != videoUDPReceiver->height) {
+        fprintf(stderr, "Error: RTP stream resolution %ux%u does not match the receive resolution %ux%u.\n", width, height, videoUDPReceiver->width, videoUDPReceiver->height);
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPReceiver->hasRTPSSRC && ssrc != videoUDPReceiver->rtpSSRC) {
+        closeAssembliesBefore(videoUDPReceiver, UINT64_MAX);
+        videoUDPReceiver->lastUTimestamp = 0;
+        videoUDPReceiver->hasRTPSequence = false;
+    }
+    videoUDPReceiver->hasRTPSSRC = true;
+    videoUDPReceiver->rtpSSRC    = ssrc;
+    int16_t sequenceDelta        = videoUDPReceiver->hasRTPSequence ? (int16_t)(sequence - videoUDPReceiver->lastRTPSequence) : 1;
+    if (sequenceDelta > 0) {
+        videoUDPReceiver->expectedPacketCount += sequenceDelta;
+        videoUDPReceiver->hasRTPSequence  = true;
+        videoUDPReceiver->lastRTPSequence = sequence;
+    }
+    uint64_t uTimestamp = VideoRTPJPEGGetUTimestamp(timestamp, VideoUDPSharedGetEpochUSeconds());
+    if (isStaleUTimestamp(videoUDPReceiver, uTimestamp)) {
+        return NULL;
+    }
+    VideoUDPReceiverAssembly* assembly = findAssembly(videoUDPReceiver, uTimestamp);
+    if (assembly == NULL) {
+        assembly = openAssembly(videoUDPReceiver, videoFramePool, 0, uTimestamp, 0, messageIndex);
+    }
+    uint32_t bodyLength    = payloadLength - headerLength;
+    uint32_t headersLength = VideoRTPJPEGGetHeadersLength(restartInterval);
+    if (assembly == NULL || assembly->flags[sequence % videoUDPReceiver->maxSlotsPerJPEG] || fragmentOffset + bodyLength > videoUDPReceiver->maxJPEGLength) {
+        return NULL;
+    }
+    memcpy(assembly->videoFrame->jpegBuffer + headersLength + fragmentOffset, payload + headerLength, bodyLength);
+    if (quantizationTables != NULL && quality >= RTP_JPEG_MIN_DYNAMIC_QUALITY) {
+        memmove(videoUDPReceiver->rtpQuantizationTables, quantizationTables, RTP_JPEG_QUANTIZATION_TABLES_LENGTH);
+        videoUDPReceiver->rtpQuality = quality;
+    } else if (quantizationTables != NULL) {
+        VideoRTPJPEGMakeQuantizationTables(quality, videoUDPReceiver->rtpQuantizationTables);
+        videoUDPReceiver->rtpQuality = quality;
+    }
+    if (quantizationTables != NULL) {
+        assembly->rtpHeadersLength = VideoRTPJPEGWriteHeaders(assembly->videoFrame->jpegBuffer, type, videoUDPReceiver->rtpQuantizationTables, width, height, restartInterval);
+    }
+    if (marker) {
+        assembly->rtpScanLength = fragmentOffset + bodyLength;
+    }
+    assembly->flags[sequence % videoUDPReceiver->maxSlotsPerJPEG] = true;
+    assembly->rtpReceivedLength += bodyLength;
+    assembly->packetsReceived++;
+    videoUDPReceiver->receivedPacketCount++;
+    videoUDPReceiver->receivedByteCount += packetLength;
+    if (assembly->rtpHeadersLength == 0 || assembly->rtpScanLength == 0 || assembly->rtpReceivedLength != assembly->rtpScanLength) {
+        return NULL;
+    }
+    return assembly;
+}
+
+static VideoFrame* finishReadyFrame(VideoUDPReceiver* videoUDPReceiver) {
+    if (!videoUDPReceiver->restart) {
+        return NULL;
+    }
+    uint64_t uNow            = getMonotonicUSeconds();
+    uint64_t uReadyTimestamp = 0;
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        VideoUDPReceiverAssembly* assembly = &videoUDPReceiver->assemblies[assemblyIndex];
+        if (assembly->active && (assembly->packetsFlagged == assembly->packetCount || assembly->partialUDeadline <= uNow) && assembly->uTimestamp > uReadyTimestamp) {
+            uReadyTimestamp = assembly->uTimestamp;
+        }
+    }
+    for (;;) {
+        VideoUDPReceiverAssembly* assembly = NULL;
+        for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+            VideoUDPReceiverAssembly* candidate = &videoUDPReceiver->assemblies[assemblyIndex];
+            if (candidate->active && candidate->uTimestamp <= uReadyTimestamp && (assembly == NULL || candidate->uTimestamp < assembly->uTimestamp)) {
+                assembly = candidate;
+            }
+        }
+        if (assembly == NULL) {
+            return NULL;
+        }
+        if (assembly->packetsFlagged == assembly->packetCount) {
+            return finishAssembly(videoUDPReceiver, assembly);
+        }
+        if (assembly->flags[0]) {
+            videoUDPReceiver->partialFrameCount++;
+            return finishAssembly(videoUDPReceiver, assembly);
+        }
+        closeAssembly(videoUDPReceiver, assembly);
+        videoUDPReceiver->incompleteFrameCount++;
+    }
+}
+
+VideoUDPReceiver* VideoUDPReceiverCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, unsigned int width, unsigned int height, unsigned int timebaseNumerator, unsigned int timebaseDenominator, struct sockaddr_in* localAddress, bool gro, unsigned int fecPercent, unsigned int nackDeadlineMSeconds, unsigned int restartDeadlineMSeconds, struct in_addr multicastInterface, struct in_addr multicastSource, unsigned int reportIntervalMSeconds, unsigned int streamId, bool rtp) {
     VideoUDPReceiver* videoUDPReceiver = malloc(sizeof(VideoUDPReceiver));
     if (videoUDPReceiver == NULL) {
         fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver.\n");
         exit(EXIT_FAILURE);
     }
-    videoUDPReceiver->maxPacketLength     = maxPacketLength;
-    videoUDPReceiver->maxJPEGLength       = maxJPEGLength;
-    videoUDPReceiver->maxPacketBodyLength = maxPacketLength - HEADER_LENGTH;
-    videoUDPReceiver->maxPacketsPerJPEG   = (maxJPEGLength / videoUDPReceiver->maxPacketBodyLength) + 1;
-    videoUDPReceiver->localAddress        = localAddress;
-    videoUDPReceiver->fd                  = -1;
-    videoUDPReceiver->flags               = malloc(videoUDPReceiver->maxPacketsPerJPEG * sizeof(bool));
+    if (streamId > MAX_STREAM_ID) {
+        fprintf(stderr, "Error: Stream id must be between 0 and %u.\n", MAX_STREAM_ID);
+        exit(EXIT_FAILURE);
+    }
+    videoUDPReceiver->maxPacketLength         = maxPacketLength;
+    videoUDPReceiver->maxJPEGLength           = maxJPEGLength;
+    videoUDPReceiver->width                   = width;
+    videoUDPReceiver->height                  = height;
+    videoUDPReceiver->timebaseNumerator       = timebaseNumerator;
+    videoUDPReceiver->timebaseDenominator     = timebaseDenominator;
+    videoUDPReceiver->streamId                = streamId;
+    videoUDPReceiver->descriptorReceivedCount = 0;
+    videoUDPReceiver->hasSequence             = false;
+    videoUDPReceiver->lastSequence            = 0;
+    videoUDPReceiver->missingFrameCount       = 0;
+    videoUDPReceiver->restart                 = restartDeadlineMSeconds > 0;
+    videoUDPReceiver->restartDeadlineUSeconds = (uint64_t)restartDeadlineMSeconds * 1000;
+    videoUDPReceiver->partialFrameCount       = 0;
+    videoUDPReceiver->fecPercent              = fecPercent;
+    videoUDPReceiver->localAddress            = localAddress;
+    videoUDPReceiver->rtp                     = rtp;
+    videoUDPReceiver->hasRTPSSRC              = false;
+    videoUDPReceiver->rtpSSRC                 = 0;
+    videoUDPReceiver->hasRTPSequence          = false;
+    videoUDPReceiver->lastRTPSequence         = 0;
+    videoUDPReceiver->rtpQuality              = 0;
+    videoUDPReceiver->unsupportedPacketCount  = 0;
+    videoUDPReceiver->fd                   = VideoUDPSharedCreateSocket(videoUDPReceiver->localAddress);
+    videoUDPReceiver->multicast            = IN_MULTICAST(ntohl(localAddress->sin_addr.s_addr));
+    videoUDPReceiver->multicastInterface   = multicastInterface;
+    videoUDPReceiver->multicastSource      = multicastSource;
+    if (!videoUDPReceiver->multicast && multicastSource.s_addr != htonl(INADDR_ANY)) {
+        fprintf(stderr, "Error: A multicast source needs a multicast local address.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPReceiver->multicast && nackDeadlineMSeconds > 0) {
+        fprintf(stderr, "Error: NACK is not supported when receiving from a multicast group.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPReceiver->multicast && reportIntervalMSeconds > 0) {
+        fprintf(stderr, "Error: Reports are not supported when receiving from a multicast group.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPReceiver->multicast && multicastSource.s_addr != htonl(INADDR_ANY)) {
+        struct ip_mreq_source membership;
+        memset(&membership, 0, sizeof(membership));
+        membership.imr_multiaddr  = localAddress->sin_addr;
+        membership.imr_interface  = multicastInterface;
+        membership.imr_sourceaddr = multicastSource;
+        if (setsockopt(videoUDPReceiver->fd, IPPROTO_IP, IP_ADD_SOURCE_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            perror("Error: join multicast source group error");
+            exit(EXIT_FAILURE);
+        }
+    } else if (videoUDPReceiver->multicast) {
+        struct ip_mreq membership;
+        memset(&membership, 0, sizeof(membership));
+        membership.imr_multiaddr = localAddress->sin_addr;
+        membership.imr_interface = multicastInterface;
+        if (setsockopt(videoUDPReceiver->fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            perror("Error: join multicast group error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (rtp && (maxPacketLength == 0 || maxJPEGLength == 0 || width == 0 || height == 0 || timebaseNumerator == 0 || timebaseDenominator == 0)) {
+        fprintf(stderr, "Error: Receiving RTP needs explicit max packet length, max JPEG length, resolution and timebase.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (rtp && (fecPercent > 0 || nackDeadlineMSeconds > 0 || restartDeadlineMSeconds > 0 || reportIntervalMSeconds > 0 || streamId > 0)) {
+        fprintf(stderr, "Error: FEC, NACK, restart, reports and stream id are not supported when receiving RTP.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (rtp && (width % 8 != 0 || height % 8 != 0 || width > RTP_JPEG_MAX_DIMENSION || height > RTP_JPEG_MAX_DIMENSION || maxPacketLength <= RTP_MIN_HEADER_LENGTH)) {
+        fprintf(stderr, "Error: Receiving RTP needs a resolution in multiples of 8 up to %ux%u and a max packet length greater than %u.\n", RTP_JPEG_MAX_DIMENSION, RTP_JPEG_MAX_DIMENSION, (unsigned int)RTP_MIN_HEADER_LENGTH);
+        exit(EXIT_FAILURE);
+    }
+    if (maxPacketLength == 0 || maxJPEGLength == 0 || width == 0 || height == 0 || timebaseNumerator == 0 || timebaseDenominator == 0) {
+        awaitDescriptor(videoUDPReceiver);
+    }
+    if (videoUDPReceiver->maxPacketLength > MAX_HEADER_FIELD || videoUDPReceiver->maxPacketLength <= HEADER_LENGTH) {
+        fprintf(stderr, "Error: Max packet length must be between %u and %u.\n", (unsigned int)HEADER_LENGTH + 1, MAX_HEADER_FIELD);
+        exit(EXIT_FAILURE);
+    }
+    videoUDPReceiver->maxPacketBodyLength     = videoUDPReceiver->maxPacketLength - (rtp ? RTP_MIN_HEADER_LENGTH : HEADER_LENGTH);
+    videoUDPReceiver->maxPacketsPerJPEG       = VideoUDPSharedGetMaxPacketCount(videoUDPReceiver->maxJPEGLength, videoUDPReceiver->maxPacketBodyLength, videoUDPReceiver->restart);
+    videoUDPReceiver->maxParityPacketsPerJPEG = VideoUDPSharedGetParityPacketCount(videoUDPReceiver->maxPacketsPerJPEG, videoUDPReceiver->fecPercent);
+    videoUDPReceiver->maxSlotsPerJPEG         = videoUDPReceiver->maxPacketsPerJPEG + videoUDPReceiver->maxParityPacketsPerJPEG;
+    videoUDPReceiver->frameBufferCapacity     = rtp ? RTP_JPEG_MAX_HEADERS_LENGTH + videoUDPReceiver->maxJPEGLength + RTP_JPEG_EOI_LENGTH : videoUDPReceiver->maxSlotsPerJPEG * videoUDPReceiver->maxPacketBodyLength;
+    if (videoUDPReceiver->maxSlotsPerJPEG > MAX_HEADER_FIELD) {
+        fprintf(stderr, "Error: Max JPEG length needs more than %u packets, raise the max packet length.\n", MAX_HEADER_FIELD);
+        exit(EXIT_FAILURE);
+    }
+    videoUDPReceiver->flags                   = malloc(VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT * videoUDPReceiver->maxSlotsPerJPEG * sizeof(bool));
     if (videoUDPReceiver->flags == NULL) {
         fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver flags.\n");
         exit(EXIT_FAILURE);
     }
-    memset(videoUDPReceiver->flags, 0, videoUDPReceiver->maxPacketsPerJPEG * sizeof(bool));
-    videoUDPReceiver->packet = malloc(maxPacketLength);
-    if (videoUDPReceiver->packet == NULL) {
-        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver packet buffer.\n");
+    memset(videoUDPReceiver->flags, 0, VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT * videoUDPReceiver->maxSlotsPerJPEG * sizeof(bool));
+    videoUDPReceiver->assemblies = malloc(VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT * sizeof(VideoUDPReceiverAssembly));
+    if (videoUDPReceiver->assemblies == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver assemblies.\n");
         exit(EXIT_FAILURE);
     }
-    memset(videoUDPReceiver->packet, 0, maxPacketLength);
-    videoUDPReceiver->jpegBuffer = malloc(maxJPEGLength);
-    if (videoUDPReceiver->jpegBuffer == NULL) {
-        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver jpeg buffer.\n");
+    memset(videoUDPReceiver->assemblies, 0, VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT * sizeof(VideoUDPReceiverAssembly));
+    videoUDPReceiver->bodyLengths = malloc(VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT * videoUDPReceiver->maxSlotsPerJPEG * sizeof(uint32_t));
+    if (videoUDPReceiver->bodyLengths == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver body lengths.\n");
         exit(EXIT_FAILURE);
     }
-    memset(videoUDPReceiver->jpegBuffer, 0, maxJPEGLength);
-    videoUDPReceiver->fd = VideoUDPSharedCreateSocket(videoUDPReceiver->localAddress);
+    for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+        videoUDPReceiver->assemblies[assemblyIndex].flags       = videoUDPReceiver->flags + assemblyIndex * videoUDPReceiver->maxSlotsPerJPEG;
+        videoUDPReceiver->assemblies[assemblyIndex].bodyLengths = videoUDPReceiver->bodyLengths + assemblyIndex * videoUDPReceiver->maxSlotsPerJPEG;
+    }
+    videoUDPReceiver->currentAssembly       = NULL;
+    videoUDPReceiver->spareFrame            = NULL;
+    videoUDPReceiver->lastUTimestamp        = 0;
+    videoUDPReceiver->incompleteFrameCount  = 0;
+    videoUDPReceiver->deliveredFrameCount   = 0;
+    videoUDPReceiver->frameIntervalUSeconds = videoUDPReceiver->timebaseDenominator > 0 ? (uint64_t)videoUDPReceiver->timebaseNumerator * 1000000 / videoUDPReceiver->timebaseDenominator : 0;
+    videoUDPReceiver->lateFrameCount        = 0;
+    videoUDPReceiver->receivedByteCount     = 0;
+    videoUDPReceiver->gro           = gro;
+    videoUDPReceiver->controls      = NULL;
+    videoUDPReceiver->batchCapacity = gro ? VIDEO_UDP_RECEIVER_GRO_BATCH_LENGTH : VIDEO_UDP_RECEIVER_BATCH_LENGTH;
+    unsigned int packetBufferLength = gro ? VIDEO_UDP_RECEIVER_GRO_BUFFER_LENGTH : videoUDPReceiver->maxPacketLength;
+    videoUDPReceiver->packets       = malloc(videoUDPReceiver->batchCapacity * packetBufferLength);
+    if (videoUDPReceiver->packets == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver packet buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoUDPReceiver->packets, 0, videoUDPReceiver->batchCapacity * packetBufferLength);
+    videoUDPReceiver->iovecs = malloc(videoUDPReceiver->batchCapacity * 2 * sizeof(struct iovec));
+    if (videoUDPReceiver->iovecs == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver iovecs.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPReceiver->messages = malloc(videoUDPReceiver->batchCapacity * sizeof(struct mmsghdr));
+    if (videoUDPReceiver->messages == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver messages.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoUDPReceiver->messages, 0, videoUDPReceiver->batchCapacity * sizeof(struct mmsghdr));
+    for (unsigned int messageIndex = 0; messageIndex < videoUDPReceiver->batchCapacity; messageIndex++) {
+        struct iovec* iovecs                                        = &videoUDPReceiver->iovecs[messageIndex * 2];
+        iovecs[0].iov_base                                          = videoUDPReceiver->packets + messageIndex * packetBufferLength;
+        iovecs[0].iov_len                                           = gro || rtp ? packetBufferLength : HEADER_LENGTH;
+        iovecs[1].iov_base                                          = gro || rtp ? NULL : getScratchBody(videoUDPReceiver, messageIndex);
+        iovecs[1].iov_len                                           = gro || rtp ? 0 : videoUDPReceiver->maxPacketBodyLength;
+        videoUDPReceiver->messages[messageIndex].msg_hdr.msg_iov    = iovecs;
+        videoUDPReceiver->messages[messageIndex].msg_hdr.msg_iovlen = gro ? 1 : 2;
+    }
+    videoUDPReceiver->batchLength          = 0;
+    videoUDPReceiver->batchOffset          = 0;
+    videoUDPReceiver->segmentOffset        = 0;
+    videoUDPReceiver->nackDeadlineUSeconds        = (uint64_t)nackDeadlineMSeconds * 1000;
+    videoUDPReceiver->senderAddresses             = NULL;
+    videoUDPReceiver->nackPacket                  = NULL;
+    videoUDPReceiver->nackSentCount               = 0;
+    videoUDPReceiver->reportIntervalUSeconds      = (uint64_t)reportIntervalMSeconds * 1000;
+    videoUDPReceiver->lastReportUTime             = getMonotonicUSeconds();
+    videoUDPReceiver->reportUDeadline             = videoUDPReceiver->lastReportUTime + videoUDPReceiver->reportIntervalUSeconds;
+    videoUDPReceiver->hasReportAddress            = false;
+    videoUDPReceiver->reportedDeliveredCount      = 0;
+    videoUDPReceiver->reportedIncompleteCount     = 0;
+    videoUDPReceiver->reportedLateCount           = 0;
+    videoUDPReceiver->reportedByteCount           = 0;
+    videoUDPReceiver->reportSentCount             = 0;
+    videoUDPReceiver->expectedPacketCount         = 0;
+    videoUDPReceiver->receivedPacketCount         = 0;
+    videoUDPReceiver->reportedExpectedPacketCount = 0;
+    videoUDPReceiver->reportedReceivedPacketCount = 0;
+    videoUDPReceiver->hasTransit                  = false;
+    videoUDPReceiver->lastTransit                 = 0;
+    videoUDPReceiver->jitterUSeconds              = 0;
+    videoUDPReceiver->replyReceivedCount          = 0;
+    videoUDPReceiver->roundTripUSeconds           = 0;
+    videoUDPReceiver->oneWayDelayUSeconds         = 0;
+    videoUDPReceiver->senderPacketCount           = 0;
+    videoUDPReceiver->senderFrameCount            = 0;
+    atomic_init(&videoUDPReceiver->clockOffsetUSeconds, 0);
+    if (videoUDPReceiver->nackDeadlineUSeconds > 0 || videoUDPReceiver->reportIntervalUSeconds > 0) {
+        videoUDPReceiver->senderAddresses = malloc(videoUDPReceiver->batchCapacity * sizeof(struct sockaddr_in));
+        if (videoUDPReceiver->senderAddresses == NULL) {
+            fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver sender addresses.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (unsigned int messageIndex = 0; messageIndex < videoUDPReceiver->batchCapacity; messageIndex++) {
+            videoUDPReceiver->messages[messageIndex].msg_hdr.msg_name = &videoUDPReceiver->senderAddresses[messageIndex];
+        }
+    }
+    if (videoUDPReceiver->nackDeadlineUSeconds > 0) {
+        videoUDPReceiver->nackPacket = malloc(videoUDPReceiver->maxPacketLength);
+        if (videoUDPReceiver->nackPacket == NULL) {
+            fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver nack packet.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (videoUDPReceiver->gro) {
+        videoUDPReceiver->controls = malloc(videoUDPReceiver->batchCapacity * CMSG_SPACE(sizeof(int)));
+        if (videoUDPReceiver->controls == NULL) {
+            fprintf(stderr, "Error: Unable to allocate memory for VideoUDPReceiver controls.\n");
+            exit(EXIT_FAILURE);
+        }
+        int enableGRO = 1;
+        if (setsockopt(videoUDPReceiver->fd, SOL_UDP, UDP_GRO, &enableGRO, sizeof(int)) < 0) {
+            perror("Error: set socket receive offload error");
+            exit(EXIT_FAILURE);
+        }
+    }
     return videoUDPReceiver;
 }
 
-bool VideoUDPReceiverReceiveFrame(VideoUDPReceiver* videoUDPReceiver) {
-    uint64_t trackedUTimestamp            = 0;
-    bool     trackedUTimestampInitialized = false;
-    uint32_t packetsFlagged               = 0;
+VideoFrame* VideoUDPReceiverReceiveFrame(VideoUDPReceiver* videoUDPReceiver, VideoFramePool* videoFramePool) {
+    VideoFrame* readyFrame = finishReadyFrame(videoUDPReceiver);
+    if (readyFrame != NULL) {
+        return readyFrame;
+    }
     for (;;) {
-        ssize_t bytesReceived = recvfrom(videoUDPReceiver->fd, videoUDPReceiver->packet, videoUDPReceiver->maxPacketLength, 0, NULL, NULL);
-        if (bytesReceived < 0 && errno == EINTR) {
+        if (videoUDPReceiver->batchOffset == videoUDPReceiver->batchLength) {
+            if (videoUDPReceiver->reportIntervalUSeconds > 0) {
+                sendDueReport(videoUDPReceiver);
+            }
+            uint64_t uDeadline = 0;
+            if (getNextUDeadline(videoUDPReceiver, &uDeadline) && !awaitPackets(videoUDPReceiver, uDeadline)) {
+                if (videoUDPReceiver->nackDeadlineUSeconds > 0) {
+                    sendDueNacks(videoUDPReceiver);
+                }
+                VideoFrame* videoFrame = finishReadyFrame(videoUDPReceiver);
+                if (videoFrame != NULL) {
+                    return videoFrame;
+                }
+                continue;
+            }
+            if (videoUDPReceiver->senderAddresses != NULL) {
+                for (unsigned int nameIndex = 0; nameIndex < videoUDPReceiver->batchCapacity; nameIndex++) {
+                    videoUDPReceiver->messages[nameIndex].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+                }
+            }
+            if (videoUDPReceiver->gro) {
+                prepareSegmentControls(videoUDPReceiver);
+            } else if (!videoUDPReceiver->rtp) {
+                if (videoUDPReceiver->currentAssembly == NULL && videoUDPReceiver->spareFrame == NULL) {
+                    videoUDPReceiver->spareFrame = VideoFramePoolAcquire(videoFramePool);
+                }
+                predictPacketBodies(videoUDPReceiver);
+            }
+            int messagesReceived = recvmmsg(videoUDPReceiver->fd, videoUDPReceiver->messages, videoUDPReceiver->batchCapacity, MSG_WAITFORONE, NULL);
+            if (messagesReceived < 0 && errno == EINTR) {
+                continue;
+            }
+            if (messagesReceived < 0 && errno == EBADF) {
+                return NULL;
+            }
+            if (messagesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                fprintf(stderr, "Socket was misconfigured non-blocking.\n");
+                exit(EXIT_FAILURE);
+            }
+            if (messagesReceived < 0) {
+                perror("Socket error.");
+                exit(EXIT_FAILURE);
+            }
+            videoUDPReceiver->batchLength   = messagesReceived;
+            videoUDPReceiver->batchOffset   = 0;
+            videoUDPReceiver->segmentOffset = 0;
             continue;
         }
-        if (bytesReceived < 0 && errno == EBADF) {
-            return false;
-        }
-        if (bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-            fprintf(stderr, "Socket was misconfigured non-blocking.\n");
-            exit(EXIT_FAILURE);
-        }
-        if (bytesReceived < 0) {
-            perror("Socket error.");
-            exit(EXIT_FAILURE);
+        unsigned int messageIndex = videoUDPReceiver->batchOffset;
+        void*        header;
+        void*        body;
+        ssize_t      bytesReceived;
+        if (videoUDPReceiver->gro) {
+            unsigned int messageLength = videoUDPReceiver->messages[messageIndex].msg_len;
+            unsigned int segmentLength = getSegmentLength(videoUDPReceiver, messageIndex);
+            header                     = videoUDPReceiver->iovecs[messageIndex * 2].iov_base + videoUDPReceiver->segmentOffset;
+            body                       = header + HEADER_LENGTH;
+            bytesReceived              = messageLength - videoUDPReceiver->segmentOffset < segmentLength ? messageLength - videoUDPReceiver->segmentOffset : segmentLength;
+            videoUDPReceiver->segmentOffset += bytesReceived;
+            if (videoUDPReceiver->segmentOffset >= messageLength) {
+                videoUDPReceiver->batchOffset++;
+                videoUDPReceiver->segmentOffset = 0;
+            }
+        } else {
+            header        = videoUDPReceiver->iovecs[messageIndex * 2].iov_base;
+            body          = videoUDPReceiver->iovecs[messageIndex * 2 + 1].iov_base;
+            bytesReceived = videoUDPReceiver->messages[messageIndex].msg_len;
+            videoUDPReceiver->batchOffset++;
         }
         if (bytesReceived == 0) {
             fprintf(stderr, "Received 0 length packet.\n");
             exit(EXIT_FAILURE);
         }
+        if (videoUDPReceiver->rtp) {
+            VideoUDPReceiverAssembly* assembly = readRTPPacket(videoUDPReceiver, videoFramePool, header, bytesReceived, messageIndex);
+            if (assembly != NULL) {
+                return finishAssembly(videoUDPReceiver, assembly);
+            }
+            continue;
+        }
         if (bytesReceived < HEADER_LENGTH) {
             fprintf(stderr, "Socket partial receive.\n");
             exit(EXIT_FAILURE);
         }
-        uint64_t beUTimestamp;
-        uint32_t bePacketIndex;
-        uint32_t bePacketCount;
-        uint32_t bePacketBodyLength;
-        memcpy(&beUTimestamp, videoUDPReceiver->packet + HEADER_UTIMESTAMP_OFFSET, HEADER_UTIMESTAMP_SIZE);
-        memcpy(&bePacketIndex, videoUDPReceiver->packet + HEADER_PACKET_INDEX_OFFSET, HEADER_PACKET_INDEX_SIZE);
-        memcpy(&bePacketCount, videoUDPReceiver->packet + HEADER_PACKET_COUNT_OFFSET, HEADER_PACKET_COUNT_SIZE);
-        memcpy(&bePacketBodyLength, videoUDPReceiver->packet + HEADER_BODY_LENGTH_OFFSET, HEADER_BODY_LENGTH_SIZE);
-        uint64_t uTimestamp       = be64toh(beUTimestamp);
-        uint32_t packetIndex      = ntohl(bePacketIndex);
-        uint32_t packetCount      = ntohl(bePacketCount);
-        uint32_t packetBodyLength = ntohl(bePacketBodyLength);
-        if (HEADER_LENGTH + packetBodyLength != bytesReceived) {
+        uint8_t  streamId;
+        uint16_t sequence;
+        uint64_t uTimestamp;
+        uint32_t packetIndex;
+        uint32_t packetCount;
+        uint32_t packetBodyLength;
+        if (!VideoUDPSharedReadHeader(header, &streamId, &sequence, &uTimestamp, &packetIndex, &packetCount, &packetBodyLength)) {
+            fprintf(stderr, "Unsupported packet header version.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (streamId != videoUDPReceiver->streamId) {
+            continue;
+        }
+        if (packetCount == CONTROL_PACKET_COUNT && packetIndex == CONTROL_TYPE_DESCRIPTOR && packetBodyLength == DESCRIPTOR_LENGTH && bytesReceived == HEADER_LENGTH + DESCRIPTOR_LENGTH) {
+            checkDescriptor(videoUDPReceiver, body, false);
+            continue;
+        }
+        if (packetCount == CONTROL_PACKET_COUNT && packetIndex == CONTROL_TYPE_REPLY && packetBodyLength == REPLY_LENGTH && bytesReceived == HEADER_LENGTH + REPLY_LENGTH && videoUDPReceiver->reportIntervalUSeconds > 0) {
+            readReply(videoUDPReceiver, body);
+            continue;
+        }
+        uint32_t parityPacketCount = VideoUDPSharedGetParityPacketCount(packetCount, videoUDPReceiver->fecPercent);
+        bool     parity            = packetIndex >= packetCount;
+        uint32_t bodyLength        = parity ? videoUDPReceiver->maxPacketBodyLength : packetBodyLength;
+        if (bytesReceived > videoUDPReceiver->maxPacketLength || HEADER_LENGTH + bodyLength != bytesReceived) {
             fprintf(stderr, "Packet length mismatch\n");
             exit(EXIT_FAILURE);
         }
-        memcpy(videoUDPReceiver->jpegBuffer + (packetIndex * videoUDPReceiver->maxPacketBodyLength), videoUDPReceiver->packet + PACKET_BODY_START_OFFSET, packetBodyLength);
-        if (!trackedUTimestampInitialized || trackedUTimestamp != uTimestamp) {
-            trackedUTimestamp            = uTimestamp;
-            trackedUTimestampInitialized = true;
-            packetsFlagged               = 0;
-            memset(videoUDPReceiver->flags, 0, videoUDPReceiver->maxPacketsPerJPEG * sizeof(bool));
+        if (packetCount == 0 || packetCount > videoUDPReceiver->maxPacketsPerJPEG || packetIndex >= packetCount + parityPacketCount || (!parity && packetBodyLength > videoUDPReceiver->maxPacketBodyLength) || (!parity && videoUDPReceiver->restart && packetBodyLength < RESTART_PREFIX_LENGTH)) {
+            fprintf(stderr, "Packet index out of range.\n");
+            exit(EXIT_FAILURE);
         }
-        if (videoUDPReceiver->flags[packetIndex]) {
+        if (isStaleUTimestamp(videoUDPReceiver, uTimestamp)) {
             continue;
         }
-        if (packetIndex == packetCount - 1) {
-            videoUDPReceiver->jpegBufferLength = (packetCount - 1) * videoUDPReceiver->maxPacketBodyLength + packetBodyLength;
-            videoUDPReceiver->uTimestamp       = trackedUTimestamp;
+        VideoUDPReceiverAssembly* assembly = findAssembly(videoUDPReceiver, uTimestamp);
+        if (assembly == NULL) {
+            assembly = openAssembly(videoUDPReceiver, videoFramePool, sequence, uTimestamp, packetCount, messageIndex);
         }
-        videoUDPReceiver->flags[packetIndex] = true;
-        packetsFlagged++;
-        if (packetsFlagged == packetCount) {
-            return true;
+        if (assembly == NULL || assembly->packetCount != packetCount || assembly->flags[packetIndex]) {
+            continue;
+        }
+        void* packetBody = assembly->videoFrame->jpegBuffer + packetIndex * videoUDPReceiver->maxPacketBodyLength;
+        if (body != packetBody) {
+            claimPacketBody(videoUDPReceiver, packetBody);
+            memcpy(packetBody, body, bodyLength);
+        }
+        videoUDPReceiver->currentAssembly = assembly;
+        assembly->nextPacketIndex         = packetIndex + 1;
+        assembly->flags[packetIndex]      = true;
+        assembly->bodyLengths[packetIndex] = packetBodyLength;
+        if (!parity) {
+            assembly->packetsFlagged++;
+            assembly->packetsReceived++;
+        }
+        videoUDPReceiver->receivedByteCount += bytesReceived;
+        uint32_t recoveredPacketIndex;
+        if (parityPacketCount > 0 && recoverPacket(videoUDPReceiver, assembly, parityPacketCount, parity ? packetIndex - packetCount : packetIndex % parityPacketCount, &recoveredPacketIndex)) {
+            assembly->flags[recoveredPacketIndex] = true;
+            assembly->packetsFlagged++;
+        }
+        if (assembly->packetsFlagged == packetCount && videoUDPReceiver->restart) {
+            return finishReadyFrame(videoUDPReceiver);
+        }
+        if (assembly->packetsFlagged == packetCount) {
+            return finishAssembly(videoUDPReceiver, assembly);
         }
     }
 }
@@ -116,9 +1080,23 @@ void VideoUDPReceiverFree(VideoUDPReceiver* videoUDPReceiver) {
             close(videoUDPReceiver->fd);
             videoUDPReceiver->fd = -1;
         }
+        for (unsigned int assemblyIndex = 0; assemblyIndex < VIDEO_UDP_RECEIVER_ASSEMBLY_COUNT; assemblyIndex++) {
+            if (videoUDPReceiver->assemblies[assemblyIndex].active) {
+                VideoFrameRelease(videoUDPReceiver->assemblies[assemblyIndex].videoFrame);
+            }
+        }
+        if (videoUDPReceiver->spareFrame != NULL) {
+            VideoFrameRelease(videoUDPReceiver->spareFrame);
+        }
         free(videoUDPReceiver->flags);
-        free(videoUDPReceiver->packet);
-        free(videoUDPReceiver->jpegBuffer);
+        free(videoUDPReceiver->bodyLengths);
+        free(videoUDPReceiver->assemblies);
+        free(videoUDPReceiver->packets);
+        free(videoUDPReceiver->iovecs);
+        free(videoUDPReceiver->messages);
+        free(videoUDPReceiver->controls);
+        free(videoUDPReceiver->senderAddresses);
+        free(videoUDPReceiver->nackPacket);
         free(videoUDPReceiver);
     }
 }
\ No newline at end of file
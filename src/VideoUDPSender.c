@@ -1,32 +1,781 @@
+#define _GNU_SOURCE
 #include "../include/VideoUDPSender.h"
+#include "../include/VideoRTPJPEG.h"
 #include "../include/VideoUDPShared.h"
 #include <endian.h>
 #include <errno.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/random.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <arpa/inet.h>
 
-VideoUDPSender* VideoUDPSenderCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress, struct sockaddr_in* remoteAddress) {
+static void readZeroCopyCompletions(VideoUDPSender* videoUDPSender) {
+    for (;;) {
+        char          control[CMSG_SPACE(sizeof(struct sock_extended_err)) + CMSG_SPACE(sizeof(struct sockaddr_in))];
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+        if (recvmsg(videoUDPSender->fd, &message, MSG_ERRQUEUE) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            perror("Socket error queue error.");
+            exit(EXIT_FAILURE);
+        }
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != NULL; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) {
+                continue;
+            }
+            struct sock_extended_err* extendedError = (struct sock_extended_err*)CMSG_DATA(cmsg);
+            if (extendedError->ee_errno != 0 || extendedError->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            uint32_t completedCount = extendedError->ee_data - extendedError->ee_info + 1;
+            videoUDPSender->zeroCopyCompletedCount += completedCount;
+            if (extendedError->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                videoUDPSender->zeroCopyCopiedCount += completedCount;
+            }
+        }
+    }
+}
+
+static void awaitZeroCopyCompletions(VideoUDPSender* videoUDPSender) {
+    readZeroCopyCompletions(videoUDPSender);
+    while (videoUDPSender->zeroCopyCompletedCount < videoUDPSender->zeroCopySentCount) {
+        struct pollfd pollFileDescriptor;
+        pollFileDescriptor.fd      = videoUDPSender->fd;
+        pollFileDescriptor.events  = 0;
+        pollFileDescriptor.revents = 0;
+        if (poll(&pollFileDescriptor, 1, -1) < 0 && errno != EINTR) {
+            perror("Socket poll error.");
+            exit(EXIT_FAILURE);
+        }
+        readZeroCopyCompletions(videoUDPSender);
+    }
+}
+
+static uint64_t getMonotonicNSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static void scheduleMessages(VideoUDPSender* videoUDPSender, uint32_t messageCount, uint64_t startNSeconds, unsigned int sendRoundIndex, unsigned int sendRounds) {
+    uint64_t roundLength = 0;
+    for (uint32_t messageIndex = 0; messageIndex < messageCount; messageIndex++) {
+        struct msghdr* message = &videoUDPSender->messages[messageIndex].msg_hdr;
+        for (size_t iovecIndex = 0; iovecIndex < message->msg_iovlen; iovecIndex++) {
+            roundLength += message->msg_iov[iovecIndex].iov_len;
+        }
+    }
+    uint64_t totalLength = roundLength * sendRounds;
+    uint64_t sentLength  = roundLength * sendRoundIndex;
+    for (uint32_t messageIndex = 0; messageIndex < messageCount; messageIndex++) {
+        struct msghdr* message                       = &videoUDPSender->messages[messageIndex].msg_hdr;
+        videoUDPSender->launchNSeconds[messageIndex] = startNSeconds + videoUDPSender->paceWindowNSeconds * sentLength / totalLength;
+        if (videoUDPSender->pacer == VIDEO_UDP_SENDER_PACER_KERNEL) {
+            memcpy(CMSG_DATA(CMSG_FIRSTHDR(message)), &videoUDPSender->launchNSeconds[messageIndex], sizeof(uint64_t));
+        }
+        for (size_t iovecIndex = 0; iovecIndex < message->msg_iovlen; iovecIndex++) {
+            sentLength += message->msg_iov[iovecIndex].iov_len;
+        }
+    }
+}
+
+static unsigned int awaitDueMessages(VideoUDPSender* videoUDPSender, uint32_t firstMessageIndex, unsigned int batchLength) {
+    struct timespec launchTime;
+    launchTime.tv_sec  = videoUDPSender->launchNSeconds[firstMessageIndex] / 1000000000;
+    launchTime.tv_nsec = videoUDPSender->launchNSeconds[firstMessageIndex] % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &launchTime, NULL) == EINTR) {
+    }
+    uint64_t     nowNSeconds = getMonotonicNSeconds();
+    unsigned int dueCount    = 1;
+    while (dueCount < batchLength && videoUDPSender->launchNSeconds[firstMessageIndex + dueCount] <= nowNSeconds) {
+        dueCount++;
+    }
+    return dueCount;
+}
+
+static uint32_t findScanStart(const uint8_t* jpeg, uint32_t jpegLength) {
+    uint32_t offset = 2;
+    while (offset + 4 <= jpegLength) {
+        if (jpeg[offset] != 0xFF) {
+            return jpegLength;
+        }
+        uint8_t markerCode = jpeg[offset + 1];
+        if (markerCode == 0xFF) {
+            offset++;
+            continue;
+        }
+        if ((markerCode >= 0xD0 && markerCode <= 0xD8) || markerCode == 0x01) {
+            offset += 2;
+            continue;
+        }
+        uint32_t segmentLength = ((uint32_t)jpeg[offset + 2] << 8) | jpeg[offset + 3];
+        offset += 2 + segmentLength;
+        if (markerCode == 0xDA) {
+            return offset < jpegLength ? offset : jpegLength;
+        }
+    }
+    return jpegLength;
+}
+
+static uint32_t packetizeFrame(VideoUDPSender* videoUDPSender, const uint8_t* jpeg, uint32_t jpegLength, uint32_t* packetOffsets, uint32_t* packetLengths, void* prefixes, unsigned int prefixStride) {
+    if (!videoUDPSender->restart) {
+        uint32_t packetCount = (jpegLength + videoUDPSender->maxPacketBodyLength - 1) / videoUDPSender->maxPacketBodyLength;
+        for (uint32_t packetIndex = 0; packetIndex < packetCount; packetIndex++) {
+            packetOffsets[packetIndex] = packetIndex * videoUDPSender->maxPacketBodyLength;
+            packetLengths[packetIndex] = packetIndex == packetCount - 1 ? jpegLength - packetOffsets[packetIndex] : videoUDPSender->maxPacketBodyLength;
+        }
+        return packetCount;
+    }
+    uint32_t capacity    = videoUDPSender->maxPacketBodyLength - RESTART_PREFIX_LENGTH;
+    uint32_t scanStart   = findScanStart(jpeg, jpegLength);
+    uint32_t packetCount = 0;
+    uint32_t offset      = 0;
+    uint32_t interval    = 0;
+    bool     boundary    = true;
+    while (offset < jpegLength) {
+        if (packetCount == videoUDPSender->maxPacketsPerJPEG) {
+            fprintf(stderr, "Restart interval packetization exceeded max packet count.\n");
+            exit(EXIT_FAILURE);
+        }
+        uint32_t limit         = jpegLength - offset < capacity ? jpegLength : offset + capacity;
+        uint32_t markerEnd     = offset > scanStart ? offset : scanStart;
+        uint32_t lastMarkerEnd = 0;
+        uint32_t markerCount   = 0;
+        while ((markerEnd = VideoUDPSharedFindRestartMarkerEnd(jpeg, markerEnd, limit)) != 0) {
+            lastMarkerEnd = markerEnd;
+            markerCount++;
+        }
+        uint32_t end               = lastMarkerEnd == 0 || limit == jpegLength ? limit : lastMarkerEnd;
+        packetOffsets[packetCount] = offset;
+        packetLengths[packetCount] = end - offset;
+        VideoUDPSharedWriteRestartPrefix(prefixes + packetCount * prefixStride, interval, markerCount, boundary);
+        interval += markerCount;
+        boundary = end == lastMarkerEnd;
+        offset   = end;
+        packetCount++;
+    }
+    return packetCount;
+}
+
+static uint32_t packetizeRTPFrame(VideoUDPSender* videoUDPSender, uint64_t uTimestamp, const uint8_t* jpeg, uint32_t jpegLength) {
+    VideoRTPJPEGFrame videoRTPJPEGFrame;
+    if (!VideoRTPJPEGParseFrame(jpeg, jpegLength, &videoRTPJPEGFrame)) {
+        return 0;
+    }
+    uint8_t  quality        = VideoRTPJPEGFindQuality(videoRTPJPEGFrame.quantizationTables);
+    uint32_t timestamp      = VideoRTPJPEGGetTimestamp(uTimestamp);
+    uint32_t packetCount    = 0;
+    uint32_t fragmentOffset = 0;
+    while (fragmentOffset < videoRTPJPEGFrame.scanLength) {
+        uint8_t* header       = videoUDPSender->headers + packetCount * videoUDPSender->headerLength;
+        uint32_t headerLength = RTP_MIN_HEADER_LENGTH;
+        VideoRTPJPEGWriteJPEGHeader(header + RTP_HEADER_LENGTH, fragmentOffset, videoRTPJPEGFrame.type, quality, videoRTPJPEGFrame.width, videoRTPJPEGFrame.height);
+        if (videoRTPJPEGFrame.restartInterval > 0) {
+            VideoRTPJPEGWriteRestartHeader(header + headerLength, videoRTPJPEGFrame.restartInterval);
+            headerLength += RTP_JPEG_RESTART_HEADER_LENGTH;
+        }
+        if (fragmentOffset == 0 && quality == RTP_JPEG_DYNAMIC_QUALITY) {
+            VideoRTPJPEGWriteQuantizationHeader(header + headerLength, videoRTPJPEGFrame.quantizationTables);
+            headerLength += RTP_JPEG_QUANTIZATION_HEADER_LENGTH + RTP_JPEG_QUANTIZATION_TABLES_LENGTH;
+        }
+        uint32_t bodyLength = videoRTPJPEGFrame.scanLength - fragmentOffset;
+        if (bodyLength > videoUDPSender->maxPacketLength - headerLength) {
+            bodyLength = videoUDPSender->maxPacketLength - headerLength;
+        }
+        VideoRTPJPEGWriteRTPHeader(header, fragmentOffset + bodyLength == videoRTPJPEGFrame.scanLength, videoUDPSender->rtpSequence++, timestamp, videoUDPSender->rtpSSRC);
+        struct iovec* iovecs = &videoUDPSender->iovecs[packetCount * 2];
+        iovecs[0].iov_base   = header;
+        iovecs[0].iov_len    = headerLength;
+        iovecs[1].iov_base   = (uint8_t*)jpeg + videoRTPJPEGFrame.scanOffset + fragmentOffset;
+        iovecs[1].iov_len    = bodyLength;
+        fragmentOffset += bodyLength;
+        packetCount++;
+    }
+    return packetCount;
+}
+
+static bool isDestinationError(int error) {
+    return error == ECONNREFUSED || error == EHOSTUNREACH || error == ENETUNREACH || error == EHOSTDOWN || error == ENETDOWN || error == EPERM;
+}
+
+static VideoUDPSenderDestination* findDestination(VideoUDPSender* videoUDPSender, struct sockaddr_in* remoteAddress) {
+    for (unsigned int destinationIndex = 0; destinationIndex < videoUDPSender->destinationCount; destinationIndex++) {
+        VideoUDPSenderDestination* destination = &videoUDPSender->destinations[destinationIndex];
+        if (destination->remoteAddress->sin_addr.s_addr == remoteAddress->sin_addr.s_addr && destination->remoteAddress->sin_port == remoteAddress->sin_port) {
+            return destination;
+        }
+    }
+    return NULL;
+}
+
+static void resendPackets(VideoUDPSender* videoUDPSender, VideoUDPSenderDestination* destination, uint16_t sequence, uint64_t uTimestamp, const void* packetIndices, uint32_t packetIndexCount) {
+    pthread_mutex_lock(&videoUDPSender->nackCacheMutex);
+    for (unsigned int cacheIndex = 0; cacheIndex < videoUDPSender->nackCacheLength; cacheIndex++) {
+        if (videoUDPSender->nackCacheJPEGLengths[cacheIndex] == 0 || videoUDPSender->nackCacheUTimestamps[cacheIndex] != uTimestamp) {
+            continue;
+        }
+        void*    jpeg        = videoUDPSender->nackCacheJPEGs + cacheIndex * videoUDPSender->maxJPEGLength;
+        uint32_t jpegLength  = videoUDPSender->nackCacheJPEGLengths[cacheIndex];
+        uint32_t packetCount = packetizeFrame(videoUDPSender, jpeg, jpegLength, videoUDPSender->nackPacketOffsets, videoUDPSender->nackPacketLengths, videoUDPSender->nackPacketPrefixes, RESTART_PREFIX_LENGTH);
+        for (uint32_t packetIndexIndex = 0; packetIndexIndex < packetIndexCount; packetIndexIndex++) {
+            uint32_t bePacketIndex;
+            memcpy(&bePacketIndex, packetIndices + packetIndexIndex * sizeof(uint32_t), sizeof(uint32_t));
+            uint32_t packetIndex = ntohl(bePacketIndex);
+            if (packetIndex >= packetCount) {
+                continue;
+            }
+            char header[HEADER_LENGTH + RESTART_PREFIX_LENGTH];
+            VideoUDPSharedWriteHeader(header, videoUDPSender->streamId, sequence, uTimestamp, packetIndex, packetCount, videoUDPSender->headerLength - HEADER_LENGTH + videoUDPSender->nackPacketLengths[packetIndex]);
+            memcpy(header + HEADER_LENGTH, videoUDPSender->nackPacketPrefixes + packetIndex * RESTART_PREFIX_LENGTH, videoUDPSender->headerLength - HEADER_LENGTH);
+            struct iovec iovecs[2];
+            iovecs[0].iov_base = header;
+            iovecs[0].iov_len  = videoUDPSender->headerLength;
+            iovecs[1].iov_base = jpeg + videoUDPSender->nackPacketOffsets[packetIndex];
+            iovecs[1].iov_len  = videoUDPSender->nackPacketLengths[packetIndex];
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_iov    = iovecs;
+            message.msg_iovlen = 2;
+            if (videoUDPSender->destinationCount > 1) {
+                message.msg_name    = destination->remoteAddress;
+                message.msg_namelen = sizeof(struct sockaddr_in);
+            }
+            ssize_t bytesSent = sendmsg(videoUDPSender->fd, &message, 0);
+            if (bytesSent < 0 && isDestinationError(errno)) {
+                destination->sendErrorCount++;
+                continue;
+            }
+            if (bytesSent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytesSent < 0) {
+                perror("Socket error.");
+                exit(EXIT_FAILURE);
+            }
+            atomic_fetch_add(&destination->sentByteCount, bytesSent);
+            atomic_fetch_add(&destination->sentPacketCount, 1);
+            atomic_fetch_add(&videoUDPSender->nackResentCount, 1);
+        }
+        break;
+    }
+    pthread_mutex_unlock(&videoUDPSender->nackCacheMutex);
+}
+
+static void adaptQuality(VideoUDPSender* videoUDPSender, uint32_t deliveredCount, uint32_t lostCount, uint32_t lateCount, uint64_t byteCount, uint32_t uSeconds) {
+    uint64_t     lossPermille = deliveredCount + lostCount > 0 ? (uint64_t)lostCount * 1000 / (deliveredCount + lostCount) : 0;
+    unsigned int quality      = atomic_load(&videoUDPSender->quality);
+    if (lossPermille > VIDEO_UDP_SENDER_MAX_LOSS_PERMILLE || lateCount > 0) {
+        quality = quality * VIDEO_UDP_SENDER_QUALITY_BACKOFF_PERCENT / 100;
+    } else if (lostCount == 0 && deliveredCount > 0) {
+        quality += VIDEO_UDP_SENDER_QUALITY_STEP;
+    }
+    quality = quality < videoUDPSender->minQuality ? videoUDPSender->minQuality : quality;
+    quality = quality > VIDEO_UDP_SENDER_MAX_QUALITY ? VIDEO_UDP_SENDER_MAX_QUALITY : quality;
+    atomic_store(&videoUDPSender->quality, quality);
+    atomic_store(&videoUDPSender->reportLossPermille, lossPermille);
+    atomic_store(&videoUDPSender->reportGoodput, uSeconds > 0 ? byteCount * 1000000 / uSeconds : 0);
+    atomic_fetch_add(&videoUDPSender->reportLateCount, lateCount);
+}
+
+static void sendReply(VideoUDPSender* videoUDPSender, VideoUDPSenderDestination* destination, uint64_t uTimestamp, uint64_t echoUTime, uint64_t receiveUTime) {
+    char reply[HEADER_LENGTH + REPLY_LENGTH];
+    VideoUDPSharedWriteHeader(reply, videoUDPSender->streamId, 0, uTimestamp, CONTROL_TYPE_REPLY, CONTROL_PACKET_COUNT, REPLY_LENGTH);
+    VideoUDPSharedWriteReply(reply + PACKET_BODY_START_OFFSET, echoUTime, receiveUTime, VideoUDPSharedGetEpochUSeconds(), atomic_load(&destination->sentPacketCount), atomic_load(&videoUDPSender->sentFrameCount));
+    struct sockaddr* remoteAddress       = videoUDPSender->destinationCount > 1 ? (struct sockaddr*)destination->remoteAddress : NULL;
+    socklen_t        remoteAddressLength = videoUDPSender->destinationCount > 1 ? sizeof(struct sockaddr_in) : 0;
+    ssize_t          bytesSent           = sendto(videoUDPSender->fd, reply, sizeof(reply), 0, remoteAddress, remoteAddressLength);
+    if (bytesSent < 0 && isDestinationError(errno)) {
+        destination->sendErrorCount++;
+        return;
+    }
+    if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == EINTR)) {
+        return;
+    }
+    if (bytesSent < 0) {
+        perror("Socket error.");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void readReport(VideoUDPSender* videoUDPSender, VideoUDPSenderDestination* destination, uint64_t uTimestamp, const void* report, uint64_t receiveUTime) {
+    uint64_t sendUTime;
+    uint32_t deliveredCount;
+    uint32_t lostCount;
+    uint32_t lateCount;
+    uint64_t byteCount;
+    uint32_t uSeconds;
+    uint32_t expectedPacketCount;
+    uint32_t lostPacketCount;
+    uint32_t jitterUSeconds;
+    uint32_t roundTripUSeconds;
+    int64_t  clockOffsetUSeconds;
+    VideoUDPSharedReadReport(report, &sendUTime, &deliveredCount, &lostCount, &lateCount, &byteCount, &uSeconds, &expectedPacketCount, &lostPacketCount, &jitterUSeconds, &roundTripUSeconds, &clockOffsetUSeconds);
+    sendReply(videoUDPSender, destination, uTimestamp, sendUTime, receiveUTime);
+    atomic_fetch_add(&destination->reportExpectedPacketCount, expectedPacketCount);
+    atomic_fetch_add(&destination->reportLostPacketCount, lostPacketCount);
+    atomic_store(&destination->reportPacketLossPermille, expectedPacketCount > 0 ? (uint64_t)lostPacketCount * 1000 / expectedPacketCount : 0);
+    atomic_store(&destination->reportJitterUSeconds, jitterUSeconds);
+    atomic_store(&destination->reportRoundTripUSeconds, roundTripUSeconds);
+    atomic_store(&destination->reportClockOffsetUSeconds, clockOffsetUSeconds);
+    atomic_fetch_add(&destination->reportReceivedCount, 1);
+    if (videoUDPSender->minQuality > 0) {
+        adaptQuality(videoUDPSender, deliveredCount, lostCount, lateCount, byteCount, uSeconds);
+    }
+    atomic_fetch_add(&videoUDPSender->reportReceivedCount, 1);
+}
+
+static void* controlLoop(void* argument) {
+    VideoUDPSender* videoUDPSender = argument;
+    while (atomic_load(&videoUDPSender->controlThreadRunning)) {
+        struct sockaddr_in requesterAddress;
+        socklen_t          requesterAddressLength = sizeof(requesterAddress);
+        ssize_t            bytesReceived          = recvfrom(videoUDPSender->fd, videoUDPSender->controlPacket, videoUDPSender->maxPacketLength, 0, (struct sockaddr*)&requesterAddress, &requesterAddressLength);
+        uint64_t           receiveUTime           = VideoUDPSharedGetEpochUSeconds();
+        if (bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNREFUSED)) {
+            continue;
+        }
+        if (bytesReceived < 0) {
+            perror("Socket error.");
+            exit(EXIT_FAILURE);
+        }
+        if (bytesReceived < HEADER_LENGTH) {
+            continue;
+        }
+        uint8_t  streamId;
+        uint16_t sequence;
+        uint64_t uTimestamp;
+        uint32_t packetIndex;
+        uint32_t packetCount;
+        uint32_t packetBodyLength;
+        bool     supported = VideoUDPSharedReadHeader(videoUDPSender->controlPacket, &streamId, &sequence, &uTimestamp, &packetIndex, &packetCount, &packetBodyLength);
+        if (!supported || streamId != videoUDPSender->streamId || packetCount != CONTROL_PACKET_COUNT || HEADER_LENGTH + packetBodyLength != bytesReceived) {
+            continue;
+        }
+        VideoUDPSenderDestination* destination = findDestination(videoUDPSender, &requesterAddress);
+        if (destination == NULL) {
+            continue;
+        }
+        if (packetIndex == CONTROL_TYPE_REPORT && packetBodyLength == REPORT_LENGTH) {
+            readReport(videoUDPSender, destination, uTimestamp, videoUDPSender->controlPacket + PACKET_BODY_START_OFFSET, receiveUTime);
+            continue;
+        }
+        if (packetIndex != CONTROL_TYPE_NACK || videoUDPSender->nackCacheLength == 0) {
+            continue;
+        }
+        atomic_fetch_add(&videoUDPSender->nackReceivedCount, 1);
+        resendPackets(videoUDPSender, destination, sequence, uTimestamp, videoUDPSender->controlPacket + PACKET_BODY_START_OFFSET, packetBodyLength / sizeof(uint32_t));
+    }
+    return NULL;
+}
+
+static void sendDescriptor(VideoUDPSender* videoUDPSender, uint64_t uTimestamp) {
+    char descriptor[HEADER_LENGTH + DESCRIPTOR_LENGTH];
+    VideoUDPSharedWriteHeader(descriptor, videoUDPSender->streamId, videoUDPSender->sequence, uTimestamp, CONTROL_TYPE_DESCRIPTOR, CONTROL_PACKET_COUNT, DESCRIPTOR_LENGTH);
+    VideoUDPSharedWriteDescriptor(descriptor + PACKET_BODY_START_OFFSET, videoUDPSender->maxPacketLength, videoUDPSender->maxJPEGLength, videoUDPSender->width, videoUDPSender->height, videoUDPSender->timebaseNumerator, videoUDPSender->timebaseDenominator, videoUDPSender->fecPercent, videoUDPSender->restart);
+    for (unsigned int destinationIndex = 0; destinationIndex < videoUDPSender->destinationCount; destinationIndex++) {
+        VideoUDPSenderDestination* destination         = &videoUDPSender->destinations[destinationIndex];
+        struct sockaddr*           remoteAddress       = videoUDPSender->destinationCount > 1 ? (struct sockaddr*)destination->remoteAddress : NULL;
+        socklen_t                  remoteAddressLength = videoUDPSender->destinationCount > 1 ? sizeof(struct sockaddr_in) : 0;
+        ssize_t                    bytesSent           = sendto(videoUDPSender->fd, descriptor, sizeof(descriptor), 0, remoteAddress, remoteAddressLength);
+        if (bytesSent < 0 && isDestinationError(errno)) {
+            destination->sendErrorCount++;
+            continue;
+        }
+        if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == EINTR)) {
+            continue;
+        }
+        if (bytesSent < 0) {
+            perror("Socket error.");
+            exit(EXIT_FAILURE);
+        }
+        videoUDPSender->descriptorSentCount++;
+    }
+    videoUDPSender->descriptorNDeadline = getMonotonicNSeconds() + (uint64_t)VIDEO_UDP_SENDER_DESCRIPTOR_INTERVAL_USECONDS * 1000;
+}
+
+static uint32_t buildMessages(VideoUDPSender* videoUDPSender, uint32_t firstPacketIndex, uint32_t packetCount, uint32_t messageCount) {
+    uint32_t packetOffset = 0;
+    while (packetOffset < packetCount) {
+        uint32_t messagePacketCount = 0;
+        while (packetOffset + messagePacketCount < packetCount && messagePacketCount < videoUDPSender->packetsPerMessage) {
+            struct iovec* iovecs = &videoUDPSender->iovecs[(firstPacketIndex + packetOffset + messagePacketCount) * 2];
+            messagePacketCount++;
+            if (iovecs[0].iov_len + iovecs[1].iov_len < videoUDPSender->maxPacketLength) {
+                break;
+            }
+        }
+        for (unsigned int destinationIndex = 0; destinationIndex < videoUDPSender->destinationCount; destinationIndex++) {
+            struct mmsghdr* message     = &videoUDPSender->messages[messageCount * videoUDPSender->destinationCount + destinationIndex];
+            message->msg_hdr.msg_iov    = &videoUDPSender->iovecs[(firstPacketIndex + packetOffset) * 2];
+            message->msg_hdr.msg_iovlen = messagePacketCount * 2;
+        }
+        packetOffset += messagePacketCount;
+        messageCount++;
+    }
+    return messageCount;
+}
+
+static uint32_t prepareFrame(VideoUDPSender* videoUDPSender, uint64_t uTimestamp, void* jpeg, uint32_t jpegLength, uint32_t* parityPacketCountOut) {
+    if (getMonotonicNSeconds() >= videoUDPSender->descriptorNDeadline) {
+        sendDescriptor(videoUDPSender, uTimestamp);
+    }
+    uint32_t packetCount       = packetizeFrame(videoUDPSender, jpeg, jpegLength, videoUDPSender->packetOffsets, videoUDPSender->packetLengths, videoUDPSender->headers + HEADER_LENGTH, videoUDPSender->headerLength);
+    uint32_t parityPacketCount = VideoUDPSharedGetParityPacketCount(packetCount, videoUDPSender->fecPercent);
+    uint32_t prefixLength      = videoUDPSender->headerLength - HEADER_LENGTH;
+    if (videoUDPSender->nackCacheLength > 0) {
+        pthread_mutex_lock(&videoUDPSender->nackCacheMutex);
+        unsigned int cacheIndex                          = videoUDPSender->nackCacheHead;
+        videoUDPSender->nackCacheHead                    = (cacheIndex + 1) % videoUDPSender->nackCacheLength;
+        videoUDPSender->nackCacheUTimestamps[cacheIndex] = uTimestamp;
+        videoUDPSender->nackCacheJPEGLengths[cacheIndex] = jpegLength;
+        memcpy(videoUDPSender->nackCacheJPEGs + cacheIndex * videoUDPSender->maxJPEGLength, jpeg, jpegLength);
+        pthread_mutex_unlock(&videoUDPSender->nackCacheMutex);
+    }
+    if (parityPacketCount > 0) {
+        memset(videoUDPSender->parityBodies, 0, parityPacketCount * videoUDPSender->maxPacketBodyLength);
+    }
+    for (uint32_t packetIndex = 0; packetIndex < packetCount; packetIndex++) {
+        struct iovec* iovecs = &videoUDPSender->iovecs[packetIndex * 2];
+        VideoUDPSharedWriteHeader(iovecs[0].iov_base, videoUDPSender->streamId, videoUDPSender->sequence, uTimestamp, packetIndex, packetCount, prefixLength + videoUDPSender->packetLengths[packetIndex]);
+        iovecs[0].iov_len  = videoUDPSender->headerLength;
+        iovecs[1].iov_base = jpeg + videoUDPSender->packetOffsets[packetIndex];
+        iovecs[1].iov_len  = videoUDPSender->packetLengths[packetIndex];
+        if (parityPacketCount > 0) {
+            void* parityBody = videoUDPSender->parityBodies + (packetIndex % parityPacketCount) * videoUDPSender->maxPacketBodyLength;
+            VideoUDPSharedXOR(parityBody, iovecs[0].iov_base + HEADER_LENGTH, prefixLength);
+            VideoUDPSharedXOR(parityBody + prefixLength, iovecs[1].iov_base, iovecs[1].iov_len);
+        }
+    }
+    for (uint32_t parityIndex = 0; parityIndex < parityPacketCount; parityIndex++) {
+        struct iovec* iovecs           = &videoUDPSender->iovecs[(packetCount + parityIndex) * 2];
+        uint32_t      parityBodyLength = 0;
+        for (uint32_t packetIndex = parityIndex; packetIndex < packetCount; packetIndex += parityPacketCount) {
+            parityBodyLength ^= prefixLength + videoUDPSender->packetLengths[packetIndex];
+        }
+        VideoUDPSharedWriteHeader(iovecs[0].iov_base, videoUDPSender->streamId, videoUDPSender->sequence, uTimestamp, packetCount + parityIndex, packetCount, parityBodyLength);
+        iovecs[0].iov_len  = HEADER_LENGTH;
+        iovecs[1].iov_base = videoUDPSender->parityBodies + parityIndex * videoUDPSender->maxPacketBodyLength;
+        iovecs[1].iov_len  = videoUDPSender->maxPacketBodyLength;
+    }
+    *parityPacketCountOut = parityPacketCount;
+    return packetCount;
+}
+
+VideoUDPSender* VideoUDPSenderCreate(unsigned int maxPacketLength, unsigned int maxJPEGLength, struct sockaddr_in* localAddress, struct sockaddr_in* remoteAddresses, unsigned int remoteAddressCount, unsigned int zeroCopyThreshold, bool gso, unsigned int fecPercent, unsigned int nackCacheLength, bool restart, unsigned int multicastTTL, struct in_addr multicastInterface, unsigned int pacePercent, unsigned int pacer, unsigned int width, unsigned int height, unsigned int timebaseNumerator, unsigned int timebaseDenominator, unsigned int minQuality, bool report, unsigned int streamId, bool rtp) {
     VideoUDPSender* videoUDPSender = malloc(sizeof(VideoUDPSender));
     if (videoUDPSender == NULL) {
         fprintf(stderr, "Error: Unable to allocate memory for VideoUDPSender.\n");
         exit(EXIT_FAILURE);
     }
-    videoUDPSender->maxPacketLength     = maxPacketLength;
-    videoUDPSender->maxJPEGLength       = maxJPEGLength;
-    videoUDPSender->maxPacketBodyLength = maxPacketLength - HEADER_LENGTH;
-    videoUDPSender->maxPacketsPerJPEG   = (maxJPEGLength / videoUDPSender->maxPacketBodyLength) + 1;
-    videoUDPSender->localAddress        = localAddress;
-    videoUDPSender->remoteAddress       = remoteAddress;
-    videoUDPSender->fd                  = -1;
-    videoUDPSender->packet              = malloc(maxPacketLength);
-    if (videoUDPSender->packet == NULL) {
-        fprintf(stderr, "Unable to allocate memory for VideoUDPSender packet.\n");
+    videoUDPSender->maxPacketLength         = maxPacketLength;
+    videoUDPSender->maxJPEGLength           = maxJPEGLength;
+    videoUDPSender->maxPacketBodyLength     = maxPacketLength - (rtp ? RTP_MAX_HEADER_LENGTH : HEADER_LENGTH);
+    videoUDPSender->maxPacketsPerJPEG       = VideoUDPSharedGetMaxPacketCount(maxJPEGLength, videoUDPSender->maxPacketBodyLength, restart);
+    videoUDPSender->fecPercent              = fecPercent;
+    videoUDPSender->maxParityPacketsPerJPEG = VideoUDPSharedGetParityPacketCount(videoUDPSender->maxPacketsPerJPEG, fecPercent);
+    videoUDPSender->localAddress            = localAddress;
+    videoUDPSender->destinationCount        = remoteAddressCount;
+    videoUDPSender->multicast               = false;
+    videoUDPSender->multicastTTL            = multicastTTL;
+    videoUDPSender->multicastInterface      = multicastInterface;
+    videoUDPSender->streamId                = streamId;
+    videoUDPSender->sequence                = 0;
+    videoUDPSender->width                   = width;
+    videoUDPSender->height                  = height;
+    videoUDPSender->timebaseNumerator       = timebaseNumerator;
+    videoUDPSender->timebaseDenominator     = timebaseDenominator;
+    videoUDPSender->descriptorNDeadline     = 0;
+    videoUDPSender->descriptorSentCount     = 0;
+    videoUDPSender->fd                      = -1;
+    videoUDPSender->gso                     = gso;
+    videoUDPSender->restart                 = restart;
+    videoUDPSender->headerLength            = rtp ? RTP_MAX_HEADER_LENGTH : HEADER_LENGTH + (restart ? RESTART_PREFIX_LENGTH : 0);
+    videoUDPSender->packetsPerMessage       = 1;
+    videoUDPSender->zeroCopyThreshold       = zeroCopyThreshold;
+    videoUDPSender->pacePercent             = pacePercent;
+    videoUDPSender->paceWindowNSeconds      = timebaseDenominator > 0 ? (uint64_t)timebaseNumerator * 1000000000 / timebaseDenominator * pacePercent / 100 : 0;
+    videoUDPSender->pacer                   = pacer;
+    videoUDPSender->paceControls            = NULL;
+    videoUDPSender->launchNSeconds          = NULL;
+    videoUDPSender->zeroCopySentCount       = 0;
+    videoUDPSender->zeroCopyCompletedCount  = 0;
+    videoUDPSender->zeroCopyCopiedCount     = 0;
+    videoUDPSender->nackCacheLength         = nackCacheLength;
+    videoUDPSender->nackCacheJPEGs          = NULL;
+    videoUDPSender->nackCacheUTimestamps    = NULL;
+    videoUDPSender->nackCacheJPEGLengths    = NULL;
+    videoUDPSender->nackCacheHead           = 0;
+    videoUDPSender->controlPacket           = NULL;
+    videoUDPSender->minQuality              = minQuality;
+    videoUDPSender->report                  = report;
+    videoUDPSender->nackPacketOffsets       = NULL;
+    videoUDPSender->nackPacketLengths       = NULL;
+    videoUDPSender->nackPacketPrefixes      = NULL;
+    videoUDPSender->rtp                     = rtp;
+    videoUDPSender->rtpSequence             = 0;
+    videoUDPSender->rtpSSRC                 = 0;
+    videoUDPSender->unsupportedFrameCount   = 0;
+    atomic_init(&videoUDPSender->controlThreadRunning, false);
+    atomic_init(&videoUDPSender->nackReceivedCount, 0);
+    atomic_init(&videoUDPSender->nackResentCount, 0);
+    atomic_init(&videoUDPSender->quality, VIDEO_UDP_SENDER_MAX_QUALITY);
+    atomic_init(&videoUDPSender->reportReceivedCount, 0);
+    atomic_init(&videoUDPSender->reportLossPermille, 0);
+    atomic_init(&videoUDPSender->reportLateCount, 0);
+    atomic_init(&videoUDPSender->reportGoodput, 0);
+    atomic_init(&videoUDPSender->sentFrameCount, 0);
+    unsigned int maxSlotsPerJPEG            = videoUDPSender->maxPacketsPerJPEG + videoUDPSender->maxParityPacketsPerJPEG;
+    if (remoteAddressCount == 0 || remoteAddressCount > VIDEO_UDP_SENDER_MAX_DESTINATIONS) {
+        fprintf(stderr, "Remote address count must be between 1 and %u.\n", VIDEO_UDP_SENDER_MAX_DESTINATIONS);
+        exit(EXIT_FAILURE);
+    }
+    videoUDPSender->destinations = malloc(remoteAddressCount * sizeof(VideoUDPSenderDestination));
+    if (videoUDPSender->destinations == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender destinations.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned int destinationIndex = 0; destinationIndex < remoteAddressCount; destinationIndex++) {
+        VideoUDPSenderDestination* destination = &videoUDPSender->destinations[destinationIndex];
+        destination->remoteAddress             = &remoteAddresses[destinationIndex];
+        destination->sendErrorCount            = 0;
+        destination->droppedPacketCount        = 0;
+        atomic_init(&destination->sentByteCount, 0);
+        atomic_init(&destination->sentPacketCount, 0);
+        atomic_init(&destination->reportReceivedCount, 0);
+        atomic_init(&destination->reportExpectedPacketCount, 0);
+        atomic_init(&destination->reportLostPacketCount, 0);
+        atomic_init(&destination->reportPacketLossPermille, 0);
+        atomic_init(&destination->reportJitterUSeconds, 0);
+        atomic_init(&destination->reportRoundTripUSeconds, 0);
+        atomic_init(&destination->reportClockOffsetUSeconds, 0);
+        if (IN_MULTICAST(ntohl(remoteAddresses[destinationIndex].sin_addr.s_addr))) {
+            videoUDPSender->multicast = true;
+        }
+    }
+    if (videoUDPSender->multicast && nackCacheLength > 0) {
+        fprintf(stderr, "NACK retransmission is not supported when sending to a multicast group.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPSender->multicast && minQuality > 0) {
+        fprintf(stderr, "Adaptive quality is not supported when sending to a multicast group.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPSender->multicast && report) {
+        fprintf(stderr, "Reports are not supported when sending to a multicast group.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (maxPacketLength > MAX_HEADER_FIELD || maxPacketLength <= HEADER_LENGTH) {
+        fprintf(stderr, "Max packet length must be between %u and %u.\n", (unsigned int)HEADER_LENGTH + 1, MAX_HEADER_FIELD);
+        exit(EXIT_FAILURE);
+    }
+    if (rtp && maxPacketLength <= RTP_MAX_HEADER_LENGTH) {
+        fprintf(stderr, "Max packet length must be greater than %u to send RTP.\n", (unsigned int)RTP_MAX_HEADER_LENGTH);
+        exit(EXIT_FAILURE);
+    }
+    if (rtp && (fecPercent > 0 || nackCacheLength > 0 || restart || minQuality > 0 || report || streamId > 0)) {
+        fprintf(stderr, "FEC, NACK, restart, adaptive quality, reports and stream id are not supported when sending RTP.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (maxSlotsPerJPEG > MAX_HEADER_FIELD) {
+        fprintf(stderr, "Max JPEG length needs more than %u packets, raise the max packet length.\n", MAX_HEADER_FIELD);
+        exit(EXIT_FAILURE);
+    }
+    if (width > MAX_HEADER_FIELD || height > MAX_HEADER_FIELD) {
+        fprintf(stderr, "Resolution must be at most %ux%u.\n", MAX_HEADER_FIELD, MAX_HEADER_FIELD);
+        exit(EXIT_FAILURE);
+    }
+    if (streamId > MAX_STREAM_ID) {
+        fprintf(stderr, "Stream id must be between 0 and %u.\n", MAX_STREAM_ID);
+        exit(EXIT_FAILURE);
+    }
+    if (restart && videoUDPSender->maxPacketBodyLength <= RESTART_PREFIX_LENGTH) {
+        fprintf(stderr, "Max packet length is too short for restart interval packetization.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPSender->headers = malloc(maxSlotsPerJPEG * videoUDPSender->headerLength);
+    if (videoUDPSender->headers == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender headers.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoUDPSender->headers, 0, maxSlotsPerJPEG * videoUDPSender->headerLength);
+    videoUDPSender->packetOffsets = malloc(videoUDPSender->maxPacketsPerJPEG * sizeof(uint32_t));
+    if (videoUDPSender->packetOffsets == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender packet offsets.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPSender->packetLengths = malloc(videoUDPSender->maxPacketsPerJPEG * sizeof(uint32_t));
+    if (videoUDPSender->packetLengths == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender packet lengths.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPSender->parityBodies = malloc(videoUDPSender->maxParityPacketsPerJPEG * videoUDPSender->maxPacketBodyLength);
+    if (videoUDPSender->parityBodies == NULL && videoUDPSender->maxParityPacketsPerJPEG > 0) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender parity bodies.\n");
+        exit(EXIT_FAILURE);
+    }
+    videoUDPSender->iovecs = malloc(maxSlotsPerJPEG * 2 * sizeof(struct iovec));
+    if (videoUDPSender->iovecs == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender iovecs.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoUDPSender->iovecs, 0, maxSlotsPerJPEG * 2 * sizeof(struct iovec));
+    videoUDPSender->messages = malloc(maxSlotsPerJPEG * remoteAddressCount * sizeof(struct mmsghdr));
+    if (videoUDPSender->messages == NULL) {
+        fprintf(stderr, "Unable to allocate memory for VideoUDPSender messages.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(videoUDPSender->messages, 0, maxSlotsPerJPEG * remoteAddressCount * sizeof(struct mmsghdr));
+    if (remoteAddressCount > 1) {
+        for (unsigned int messageIndex = 0; messageIndex < maxSlotsPerJPEG * remoteAddressCount; messageIndex++) {
+            videoUDPSender->messages[messageIndex].msg_hdr.msg_name    = &remoteAddresses[messageIndex % remoteAddressCount];
+            videoUDPSender->messages[messageIndex].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        }
+    }
+    for (unsigned int packetIndex = 0; packetIndex < maxSlotsPerJPEG; packetIndex++) {
+        struct iovec* iovecs = &videoUDPSender->iovecs[packetIndex * 2];
+        iovecs[0].iov_base   = videoUDPSender->headers + packetIndex * videoUDPSender->headerLength;
+        iovecs[0].iov_len    = HEADER_LENGTH;
+    }
+    if (rtp && (getrandom(&videoUDPSender->rtpSequence, sizeof(uint16_t), 0) != sizeof(uint16_t) || getrandom(&videoUDPSender->rtpSSRC, sizeof(uint32_t), 0) != sizeof(uint32_t))) {
+        perror("Error: RTP random initialization error");
         exit(EXIT_FAILURE);
     }
     videoUDPSender->fd = VideoUDPSharedCreateSocket(videoUDPSender->localAddress);
+    if (remoteAddressCount == 1 && connect(videoUDPSender->fd, (struct sockaddr*)remoteAddresses, sizeof(struct sockaddr_in)) < 0) {
+        perror("Error: connect socket error");
+        exit(EXIT_FAILURE);
+    }
+    if (videoUDPSender->multicast && multicastTTL > 0) {
+        int ttl = multicastTTL;
+        if (setsockopt(videoUDPSender->fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(int)) < 0) {
+            perror("Error: set socket multicast ttl error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (videoUDPSender->multicast && multicastInterface.s_addr != htonl(INADDR_ANY)) {
+        if (setsockopt(videoUDPSender->fd, IPPROTO_IP, IP_MULTICAST_IF, &multicastInterface, sizeof(struct in_addr)) < 0) {
+            perror("Error: set socket multicast interface error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (videoUDPSender->gso) {
+        int gsoSize = videoUDPSender->maxPacketLength;
+        if (setsockopt(videoUDPSender->fd, SOL_UDP, UDP_SEGMENT, &gsoSize, sizeof(int)) < 0) {
+            perror("Error: set socket segmentation offload error");
+            exit(EXIT_FAILURE);
+        }
+        videoUDPSender->packetsPerMessage = VIDEO_UDP_SENDER_MAX_GSO_LENGTH / videoUDPSender->maxPacketLength;
+        if (videoUDPSender->packetsPerMessage == 0) {
+            fprintf(stderr, "Max packet length is too long for segmentation offload.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (videoUDPSender->packetsPerMessage > VIDEO_UDP_SENDER_MAX_GSO_SEGMENTS) {
+            videoUDPSender->packetsPerMessage = VIDEO_UDP_SENDER_MAX_GSO_SEGMENTS;
+        }
+        if (videoUDPSender->zeroCopyThreshold > 0 && videoUDPSender->packetsPerMessage > VIDEO_UDP_SENDER_MAX_ZERO_COPY_FRAGMENTS / 3) {
+            videoUDPSender->packetsPerMessage = VIDEO_UDP_SENDER_MAX_ZERO_COPY_FRAGMENTS / 3;
+        }
+    }
+    if (videoUDPSender->zeroCopyThreshold > 0) {
+        int zeroCopy = 1;
+        if (setsockopt(videoUDPSender->fd, SOL_SOCKET, SO_ZEROCOPY, &zeroCopy, sizeof(int)) < 0) {
+            perror("Error: set socket zero copy error");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (pacePercent > 0 && pacer == VIDEO_UDP_SENDER_PACER_KERNEL) {
+        struct sock_txtime txTime;
+        txTime.clockid = CLOCK_MONOTONIC;
+        txTime.flags   = 0;
+        if (setsockopt(videoUDPSender->fd, SOL_SOCKET, SO_TXTIME, &txTime, sizeof(txTime)) < 0) {
+            videoUDPSender->pacer = VIDEO_UDP_SENDER_PACER_USER;
+        }
+    }
+    if (pacePercent > 0) {
+        videoUDPSender->launchNSeconds = malloc(maxSlotsPerJPEG * remoteAddressCount * sizeof(uint64_t));
+        if (videoUDPSender->launchNSeconds == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender launch times.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (pacePercent > 0 && videoUDPSender->pacer == VIDEO_UDP_SENDER_PACER_KERNEL) {
+        videoUDPSender->paceControls = malloc(maxSlotsPerJPEG * remoteAddressCount * CMSG_SPACE(sizeof(uint64_t)));
+        if (videoUDPSender->paceControls == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender pacing controls.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(videoUDPSender->paceControls, 0, maxSlotsPerJPEG * remoteAddressCount * CMSG_SPACE(sizeof(uint64_t)));
+        for (unsigned int messageIndex = 0; messageIndex < maxSlotsPerJPEG * remoteAddressCount; messageIndex++) {
+            struct msghdr* message  = &videoUDPSender->messages[messageIndex].msg_hdr;
+            message->msg_control    = videoUDPSender->paceControls + messageIndex * CMSG_SPACE(sizeof(uint64_t));
+            message->msg_controllen = CMSG_SPACE(sizeof(uint64_t));
+            struct cmsghdr* cmsg    = CMSG_FIRSTHDR(message);
+            cmsg->cmsg_level        = SOL_SOCKET;
+            cmsg->cmsg_type         = SCM_TXTIME;
+            cmsg->cmsg_len          = CMSG_LEN(sizeof(uint64_t));
+        }
+    }
+    if (videoUDPSender->nackCacheLength > 0) {
+        videoUDPSender->nackCacheJPEGs = malloc(videoUDPSender->nackCacheLength * videoUDPSender->maxJPEGLength);
+        if (videoUDPSender->nackCacheJPEGs == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender nack cache.\n");
+            exit(EXIT_FAILURE);
+        }
+        videoUDPSender->nackCacheUTimestamps = malloc(videoUDPSender->nackCacheLength * sizeof(uint64_t));
+        if (videoUDPSender->nackCacheUTimestamps == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender nack cache timestamps.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(videoUDPSender->nackCacheUTimestamps, 0, videoUDPSender->nackCacheLength * sizeof(uint64_t));
+        videoUDPSender->nackCacheJPEGLengths = malloc(videoUDPSender->nackCacheLength * sizeof(unsigned int));
+        if (videoUDPSender->nackCacheJPEGLengths == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender nack cache lengths.\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(videoUDPSender->nackCacheJPEGLengths, 0, videoUDPSender->nackCacheLength * sizeof(unsigned int));
+        videoUDPSender->nackPacketOffsets  = malloc(videoUDPSender->maxPacketsPerJPEG * sizeof(uint32_t));
+        videoUDPSender->nackPacketLengths  = malloc(videoUDPSender->maxPacketsPerJPEG * sizeof(uint32_t));
+        videoUDPSender->nackPacketPrefixes = malloc(videoUDPSender->maxPacketsPerJPEG * RESTART_PREFIX_LENGTH);
+        if (videoUDPSender->nackPacketOffsets == NULL || videoUDPSender->nackPacketLengths == NULL || videoUDPSender->nackPacketPrefixes == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender nack packet layout.\n");
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_init(&videoUDPSender->nackCacheMutex, NULL);
+    }
+    if (videoUDPSender->nackCacheLength > 0 || videoUDPSender->minQuality > 0 || videoUDPSender->report) {
+        videoUDPSender->controlPacket = malloc(videoUDPSender->maxPacketLength);
+        if (videoUDPSender->controlPacket == NULL) {
+            fprintf(stderr, "Unable to allocate memory for VideoUDPSender control packet.\n");
+            exit(EXIT_FAILURE);
+        }
+        struct timeval receiveTimeout;
+        receiveTimeout.tv_sec  = VIDEO_UDP_SENDER_NACK_TIMEOUT_USECONDS / 1000000;
+        receiveTimeout.tv_usec = VIDEO_UDP_SENDER_NACK_TIMEOUT_USECONDS % 1000000;
+        if (setsockopt(videoUDPSender->fd, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout)) < 0) {
+            perror("Error: set socket receive timeout error");
+            exit(EXIT_FAILURE);
+        }
+        atomic_store(&videoUDPSender->controlThreadRunning, true);
+        if (pthread_create(&videoUDPSender->controlThread, NULL, controlLoop, videoUDPSender) != 0) {
+            fprintf(stderr, "Unable to create VideoUDPSender control thread.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
     return videoUDPSender;
 }
 
@@ -39,43 +788,106 @@ void VideoUDPSenderSendFrame(VideoUDPSender* videoUDPSender, uint64_t uTimestamp
         fprintf(stderr, "Payload length was greater than max jpeg length.\n");
         exit(EXIT_FAILURE);
     }
-    uint64_t beUTimestamp  = htobe64(uTimestamp);
-    uint32_t packetCount   = (jpegLength + videoUDPSender->maxPacketBodyLength - 1) / videoUDPSender->maxPacketBodyLength;
-    uint32_t bePacketCount = htonl(packetCount);
+    uint32_t packetCount       = 0;
+    uint32_t parityPacketCount = 0;
+    if (videoUDPSender->rtp) {
+        packetCount = packetizeRTPFrame(videoUDPSender, uTimestamp, jpeg, jpegLength);
+    } else {
+        packetCount = prepareFrame(videoUDPSender, uTimestamp, jpeg, jpegLength, &parityPacketCount);
+    }
+    if (packetCount == 0) {
+        videoUDPSender->unsupportedFrameCount++;
+        return;
+    }
+    uint32_t messageCount = buildMessages(videoUDPSender, 0, packetCount, 0);
+    messageCount          = buildMessages(videoUDPSender, packetCount, parityPacketCount, messageCount);
+    messageCount *= videoUDPSender->destinationCount;
+    bool     zeroCopy      = videoUDPSender->zeroCopyThreshold > 0 && jpegLength >= videoUDPSender->zeroCopyThreshold;
+    uint64_t startNSeconds = videoUDPSender->pacePercent > 0 ? getMonotonicNSeconds() : 0;
     for (unsigned int sendRoundIndex = 0; sendRoundIndex < sendRounds; sendRoundIndex++) {
-        for (uint32_t packetIndex = 0; packetIndex < packetCount; packetIndex++) {
-            uint32_t bePacketIndex      = htonl(packetIndex);
-            uint32_t packetBodyLength   = (packetIndex == packetCount - 1) ? jpegLength - packetIndex * videoUDPSender->maxPacketBodyLength : videoUDPSender->maxPacketBodyLength;
-            uint32_t bePacketBodyLength = htonl(packetBodyLength);
-            memcpy(videoUDPSender->packet + HEADER_UTIMESTAMP_OFFSET, &beUTimestamp, HEADER_UTIMESTAMP_SIZE);
-            memcpy(videoUDPSender->packet + HEADER_PACKET_INDEX_OFFSET, &bePacketIndex, HEADER_PACKET_INDEX_SIZE);
-            memcpy(videoUDPSender->packet + HEADER_PACKET_COUNT_OFFSET, &bePacketCount, HEADER_PACKET_COUNT_SIZE);
-            memcpy(videoUDPSender->packet + HEADER_BODY_LENGTH_OFFSET, &bePacketBodyLength, HEADER_BODY_LENGTH_SIZE);
-            memcpy(videoUDPSender->packet + PACKET_BODY_START_OFFSET, jpeg + packetIndex * videoUDPSender->maxPacketBodyLength, packetBodyLength);
-            ssize_t bytesSent = sendto(videoUDPSender->fd, videoUDPSender->packet, HEADER_LENGTH + packetBodyLength, 0, (struct sockaddr*)videoUDPSender->remoteAddress, sizeof(struct sockaddr_in));
-            if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-                fprintf(stderr, "Socket was misconfigured non-blocking.\n");
-                exit(EXIT_FAILURE);
+        uint32_t messagesSent = 0;
+        if (videoUDPSender->pacePercent > 0) {
+            scheduleMessages(videoUDPSender, messageCount, startNSeconds, sendRoundIndex, sendRounds);
+        }
+        while (messagesSent < messageCount) {
+            unsigned int batchLength = messageCount - messagesSent < VIDEO_UDP_SENDER_MAX_BATCH_LENGTH ? messageCount - messagesSent : VIDEO_UDP_SENDER_MAX_BATCH_LENGTH;
+            if (videoUDPSender->pacePercent > 0 && videoUDPSender->pacer == VIDEO_UDP_SENDER_PACER_USER) {
+                batchLength = awaitDueMessages(videoUDPSender, messagesSent, batchLength);
             }
-            if (bytesSent < 0 && errno == EINTR) {
-                packetIndex--;
+            int                        result      = sendmmsg(videoUDPSender->fd, &videoUDPSender->messages[messagesSent], batchLength, zeroCopy ? MSG_ZEROCOPY : 0);
+            VideoUDPSenderDestination* destination = &videoUDPSender->destinations[messagesSent % videoUDPSender->destinationCount];
+            if (result < 0 && errno == ECONNREFUSED) {
+                destination->sendErrorCount++;
                 continue;
             }
-            if (bytesSent < 0) {
+            if (result < 0 && isDestinationError(errno)) {
+                destination->sendErrorCount++;
+                messagesSent++;
+                continue;
+            }
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result < 0 && errno == ENOBUFS && zeroCopy) {
+                awaitZeroCopyCompletions(videoUDPSender);
+                continue;
+            }
+            if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)) {
+                destination->droppedPacketCount += videoUDPSender->messages[messagesSent].msg_hdr.msg_iovlen / 2;
+                messagesSent++;
+                continue;
+            }
+            if (result < 0) {
                 perror("Socket error.");
                 exit(EXIT_FAILURE);
             }
+            for (int messageIndex = 0; messageIndex < result; messageIndex++) {
+                VideoUDPSenderDestination* sentDestination = &videoUDPSender->destinations[(messagesSent + messageIndex) % videoUDPSender->destinationCount];
+                atomic_fetch_add(&sentDestination->sentByteCount, videoUDPSender->messages[messagesSent + messageIndex].msg_len);
+                atomic_fetch_add(&sentDestination->sentPacketCount, videoUDPSender->messages[messagesSent + messageIndex].msg_hdr.msg_iovlen / 2);
+            }
+            messagesSent += result;
+            if (zeroCopy) {
+                videoUDPSender->zeroCopySentCount += result;
+            }
         }
     }
+    if (zeroCopy) {
+        awaitZeroCopyCompletions(videoUDPSender);
+    }
+    atomic_fetch_add(&videoUDPSender->sentFrameCount, 1);
+    videoUDPSender->sequence++;
 }
 
 void VideoUDPSenderFree(VideoUDPSender* videoUDPSender) {
     if (videoUDPSender != NULL) {
+        if (videoUDPSender->nackCacheLength > 0 || videoUDPSender->minQuality > 0 || videoUDPSender->report) {
+            atomic_store(&videoUDPSender->controlThreadRunning, false);
+            pthread_join(videoUDPSender->controlThread, NULL);
+        }
+        if (videoUDPSender->nackCacheLength > 0) {
+            pthread_mutex_destroy(&videoUDPSender->nackCacheMutex);
+        }
         if (videoUDPSender->fd >= 0) {
             close(videoUDPSender->fd);
             videoUDPSender->fd = -1;
         }
-        free(videoUDPSender->packet);
+        free(videoUDPSender->headers);
+        free(videoUDPSender->packetOffsets);
+        free(videoUDPSender->packetLengths);
+        free(videoUDPSender->nackPacketOffsets);
+        free(videoUDPSender->nackPacketLengths);
+        free(videoUDPSender->nackPacketPrefixes);
+        free(videoUDPSender->parityBodies);
+        free(videoUDPSender->nackCacheJPEGs);
+        free(videoUDPSender->nackCacheUTimestamps);
+        free(videoUDPSender->nackCacheJPEGLengths);
+        free(videoUDPSender->controlPacket);
+        free(videoUDPSender->iovecs);
+        free(videoUDPSender->messages);
+        free(videoUDPSender->destinations);
+        free(videoUDPSender->paceControls);
+        free(videoUDPSender->launchNSeconds);
         free(videoUDPSender);
     }
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "../include/VideoUDPShared.h"
+#include <arpa/inet.h>
+#include <endian.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 #include <unistd.h>
 
 int VideoUDPSharedCreateSocket(struct sockaddr_in* localAddress) {
@@ -33,4 +37,254 @@ int VideoUDPSharedCreateSocket(struct sockaddr_in* localAddress) {
         exit(EXIT_FAILURE);
     }
     return fd;
+}
+
+void VideoUDPSharedWriteHeader(void* header, uint8_t streamId, uint16_t sequence, uint64_t uTimestamp, uint32_t packetIndex, uint32_t packetCount, uint32_t packetBodyLength) {
+    uint8_t  version            = HEADER_VERSION;
+    uint16_t beSequence         = htons(sequence);
+    uint64_t beUTimestamp       = htobe64(uTimestamp);
+    uint16_t bePacketIndex      = htons(packetIndex);
+    uint16_t bePacketCount      = htons(packetCount);
+    uint16_t bePacketBodyLength = htons(packetBodyLength);
+    memcpy(header + HEADER_VERSION_OFFSET, &version, HEADER_VERSION_SIZE);
+    memcpy(header + HEADER_STREAM_ID_OFFSET, &streamId, HEADER_STREAM_ID_SIZE);
+    memcpy(header + HEADER_SEQUENCE_OFFSET, &beSequence, HEADER_SEQUENCE_SIZE);
+    memcpy(header + HEADER_UTIMESTAMP_OFFSET, &beUTimestamp, HEADER_UTIMESTAMP_SIZE);
+    memcpy(header + HEADER_PACKET_INDEX_OFFSET, &bePacketIndex, HEADER_PACKET_INDEX_SIZE);
+    memcpy(header + HEADER_PACKET_COUNT_OFFSET, &bePacketCount, HEADER_PACKET_COUNT_SIZE);
+    memcpy(header + HEADER_BODY_LENGTH_OFFSET, &bePacketBodyLength, HEADER_BODY_LENGTH_SIZE);
+}
+
+bool VideoUDPSharedReadHeader(const void* header, uint8_t* streamId, uint16_t* sequence, uint64_t* uTimestamp, uint32_t* packetIndex, uint32_t* packetCount, uint32_t* packetBodyLength) {
+    uint8_t  version;
+    uint16_t beSequence;
+    uint64_t beUTimestamp;
+    uint16_t bePacketIndex;
+    uint16_t bePacketCount;
+    uint16_t bePacketBodyLength;
+    memcpy(&version, header + HEADER_VERSION_OFFSET, HEADER_VERSION_SIZE);
+    memcpy(streamId, header + HEADER_STREAM_ID_OFFSET, HEADER_STREAM_ID_SIZE);
+    memcpy(&beSequence, header + HEADER_SEQUENCE_OFFSET, HEADER_SEQUENCE_SIZE);
+    memcpy(&beUTimestamp, header + HEADER_UTIMESTAMP_OFFSET, HEADER_UTIMESTAMP_SIZE);
+    memcpy(&bePacketIndex, header + HEADER_PACKET_INDEX_OFFSET, HEADER_PACKET_INDEX_SIZE);
+    memcpy(&bePacketCount, header + HEADER_PACKET_COUNT_OFFSET, HEADER_PACKET_COUNT_SIZE);
+    memcpy(&bePacketBodyLength, header + HEADER_BODY_LENGTH_OFFSET, HEADER_BODY_LENGTH_SIZE);
+    *sequence         = ntohs(beSequence);
+    *uTimestamp       = be64toh(beUTimestamp);
+    *packetIndex      = ntohs(bePacketIndex);
+    *packetCount      = ntohs(bePacketCount);
+    *packetBodyLength = ntohs(bePacketBodyLength);
+    return version == HEADER_VERSION;
+}
+
+void VideoUDPSharedWriteRestartPrefix(void* prefix, uint32_t firstInterval, uint16_t markerCount, bool boundary) {
+    uint32_t beFirstInterval = htonl(firstInterval);
+    uint16_t beMarkerCount   = htons(markerCount);
+    uint16_t beFlags         = htons(boundary ? RESTART_PREFIX_FLAG_BOUNDARY : 0);
+    memcpy(prefix + RESTART_PREFIX_INTERVAL_OFFSET, &beFirstInterval, RESTART_PREFIX_INTERVAL_SIZE);
+    memcpy(prefix + RESTART_PREFIX_MARKER_COUNT_OFFSET, &beMarkerCount, RESTART_PREFIX_MARKER_COUNT_SIZE);
+    memcpy(prefix + RESTART_PREFIX_FLAGS_OFFSET, &beFlags, RESTART_PREFIX_FLAGS_SIZE);
+}
+
+void VideoUDPSharedReadRestartPrefix(const void* prefix, uint32_t* firstInterval, uint16_t* markerCount, bool* boundary) {
+    uint32_t beFirstInterval;
+    uint16_t beMarkerCount;
+    uint16_t beFlags;
+    memcpy(&beFirstInterval, prefix + RESTART_PREFIX_INTERVAL_OFFSET, RESTART_PREFIX_INTERVAL_SIZE);
+    memcpy(&beMarkerCount, prefix + RESTART_PREFIX_MARKER_COUNT_OFFSET, RESTART_PREFIX_MARKER_COUNT_SIZE);
+    memcpy(&beFlags, prefix + RESTART_PREFIX_FLAGS_OFFSET, RESTART_PREFIX_FLAGS_SIZE);
+    *firstInterval = ntohl(beFirstInterval);
+    *markerCount   = ntohs(beMarkerCount);
+    *boundary      = (ntohs(beFlags) & RESTART_PREFIX_FLAG_BOUNDARY) != 0;
+}
+
+void VideoUDPSharedWriteReport(void* report, uint64_t sendUTime, uint32_t deliveredCount, uint32_t lostCount, uint32_t lateCount, uint64_t byteCount, uint32_t uSeconds, uint32_t expectedPacketCount, uint32_t lostPacketCount, uint32_t jitterUSeconds, uint32_t roundTripUSeconds, int64_t clockOffsetUSeconds) {
+    uint64_t beSendUTime           = htobe64(sendUTime);
+    uint32_t beDeliveredCount      = htonl(deliveredCount);
+    uint32_t beLostCount           = htonl(lostCount);
+    uint32_t beLateCount           = htonl(lateCount);
+    uint64_t beByteCount           = htobe64(byteCount);
+    uint32_t beUSeconds            = htonl(uSeconds);
+    uint32_t beExpectedPacketCount = htonl(expectedPacketCount);
+    uint32_t beLostPacketCount     = htonl(lostPacketCount);
+    uint32_t beJitterUSeconds      = htonl(jitterUSeconds);
+    uint32_t beRoundTripUSeconds   = htonl(roundTripUSeconds);
+    uint64_t beClockOffsetUSeconds = htobe64((uint64_t)clockOffsetUSeconds);
+    memcpy(report + REPORT_SEND_UTIME_OFFSET, &beSendUTime, REPORT_SEND_UTIME_SIZE);
+    memcpy(report + REPORT_DELIVERED_COUNT_OFFSET, &beDeliveredCount, REPORT_DELIVERED_COUNT_SIZE);
+    memcpy(report + REPORT_LOST_COUNT_OFFSET, &beLostCount, REPORT_LOST_COUNT_SIZE);
+    memcpy(report + REPORT_LATE_COUNT_OFFSET, &beLateCount, REPORT_LATE_COUNT_SIZE);
+    memcpy(report + REPORT_BYTE_COUNT_OFFSET, &beByteCount, REPORT_BYTE_COUNT_SIZE);
+    memcpy(report + REPORT_USECONDS_OFFSET, &beUSeconds, REPORT_USECONDS_SIZE);
+    memcpy(report + REPORT_EXPECTED_PACKET_COUNT_OFFSET, &beExpectedPacketCount, REPORT_EXPECTED_PACKET_COUNT_SIZE);
+    memcpy(report + REPORT_LOST_PACKET_COUNT_OFFSET, &beLostPacketCount, REPORT_LOST_PACKET_COUNT_SIZE);
+    memcpy(report + REPORT_JITTER_USECONDS_OFFSET, &beJitterUSeconds, REPORT_JITTER_USECONDS_SIZE);
+    memcpy(report + REPORT_ROUND_TRIP_USECONDS_OFFSET, &beRoundTripUSeconds, REPORT_ROUND_TRIP_USECONDS_SIZE);
+    memcpy(report + REPORT_CLOCK_OFFSET_USECONDS_OFFSET, &beClockOffsetUSeconds, REPORT_CLOCK_OFFSET_USECONDS_SIZE);
+}
+
+void VideoUDPSharedReadReport(const void* report, uint64_t* sendUTime, uint32_t* deliveredCount, uint32_t* lostCount, uint32_t* lateCount, uint64_t* byteCount, uint32_t* uSeconds, uint32_t* expectedPacketCount, uint32_t* lostPacketCount, uint32_t* jitterUSeconds, uint32_t* roundTripUSeconds, int64_t* clockOffsetUSeconds) {
+    uint64_t beSendUTime;
+    uint32_t beDeliveredCount;
+    uint32_t beLostCount;
+    uint32_t beLateCount;
+    uint64_t beByteCount;
+    uint32_t beUSeconds;
+    uint32_t beExpectedPacketCount;
+    uint32_t beLostPacketCount;
+    uint32_t beJitterUSeconds;
+    uint32_t beRoundTripUSeconds;
+    uint64_t beClockOffsetUSeconds;
+    memcpy(&beSendUTime, report + REPORT_SEND_UTIME_OFFSET, REPORT_SEND_UTIME_SIZE);
+    memcpy(&beDeliveredCount, report + REPORT_DELIVERED_COUNT_OFFSET, REPORT_DELIVERED_COUNT_SIZE);
+    memcpy(&beLostCount, report + REPORT_LOST_COUNT_OFFSET, REPORT_LOST_COUNT_SIZE);
+    memcpy(&beLateCount, report + REPORT_LATE_COUNT_OFFSET, REPORT_LATE_COUNT_SIZE);
+    memcpy(&beByteCount, report + REPORT_BYTE_COUNT_OFFSET, REPORT_BYTE_COUNT_SIZE);
+    memcpy(&beUSeconds, report + REPORT_USECONDS_OFFSET, REPORT_USECONDS_SIZE);
+    memcpy(&beExpectedPacketCount, report + REPORT_EXPECTED_PACKET_COUNT_OFFSET, REPORT_EXPECTED_PACKET_COUNT_SIZE);
+    memcpy(&beLostPacketCount, report + REPORT_LOST_PACKET_COUNT_OFFSET, REPORT_LOST_PACKET_COUNT_SIZE);
+    memcpy(&beJitterUSeconds, report + REPORT_JITTER_USECONDS_OFFSET, REPORT_JITTER_USECONDS_SIZE);
+    memcpy(&beRoundTripUSeconds, report + REPORT_ROUND_TRIP_USECONDS_OFFSET, REPORT_ROUND_TRIP_USECONDS_SIZE);
+    memcpy(&beClockOffsetUSeconds, report + REPORT_CLOCK_OFFSET_USECONDS_OFFSET, REPORT_CLOCK_OFFSET_USECONDS_SIZE);
+    *sendUTime           = be64toh(beSendUTime);
+    *deliveredCount      = ntohl(beDeliveredCount);
+    *lostCount           = ntohl(beLostCount);
+    *lateCount           = ntohl(beLateCount);
+    *byteCount           = be64toh(beByteCount);
+    *uSeconds            = ntohl(beUSeconds);
+    *expectedPacketCount = ntohl(beExpectedPacketCount);
+    *lostPacketCount     = ntohl(beLostPacketCount);
+    *jitterUSeconds      = ntohl(beJitterUSeconds);
+    *roundTripUSeconds   = ntohl(beRoundTripUSeconds);
+    *clockOffsetUSeconds = (int64_t)be64toh(beClockOffsetUSeconds);
+}
+
+void VideoUDPSharedWriteReply(void* reply, uint64_t echoUTime, uint64_t receiveUTime, uint64_t sendUTime, uint64_t sentPacketCount, uint64_t sentFrameCount) {
+    uint64_t beEchoUTime       = htobe64(echoUTime);
+    uint64_t beReceiveUTime    = htobe64(receiveUTime);
+    uint64_t beSendUTime       = htobe64(sendUTime);
+    uint64_t beSentPacketCount = htobe64(sentPacketCount);
+    uint64_t beSentFrameCount  = htobe64(sentFrameCount);
+    memcpy(reply + REPLY_ECHO_UTIME_OFFSET, &beEchoUTime, REPLY_ECHO_UTIME_SIZE);
+    memcpy(reply + REPLY_RECEIVE_UTIME_OFFSET, &beReceiveUTime, REPLY_RECEIVE_UTIME_SIZE);
+    memcpy(reply + REPLY_SEND_UTIME_OFFSET, &beSendUTime, REPLY_SEND_UTIME_SIZE);
+    memcpy(reply + REPLY_SENT_PACKET_COUNT_OFFSET, &beSentPacketCount, REPLY_SENT_PACKET_COUNT_SIZE);
+    memcpy(reply + REPLY_SENT_FRAME_COUNT_OFFSET, &beSentFrameCount, REPLY_SENT_FRAME_COUNT_SIZE);
+}
+
+void VideoUDPSharedReadReply(const void* reply, uint64_t* echoUTime, uint64_t* receiveUTime, uint64_t* sendUTime, uint64_t* sentPacketCount, uint64_t* sentFrameCount) {
+    uint64_t beEchoUTime;
+    uint64_t beReceiveUTime;
+    uint64_t beSendUTime;
+    uint64_t beSentPacketCount;
+    uint64_t beSentFrameCount;
+    memcpy(&beEchoUTime, reply + REPLY_ECHO_UTIME_OFFSET, REPLY_ECHO_UTIME_SIZE);
+    memcpy(&beReceiveUTime, reply + REPLY_RECEIVE_UTIME_OFFSET, REPLY_RECEIVE_UTIME_SIZE);
+    memcpy(&beSendUTime, reply + REPLY_SEND_UTIME_OFFSET, REPLY_SEND_UTIME_SIZE);
+    memcpy(&beSentPacketCount, reply + REPLY_SENT_PACKET_COUNT_OFFSET, REPLY_SENT_PACKET_COUNT_SIZE);
+    memcpy(&beSentFrameCount, reply + REPLY_SENT_FRAME_COUNT_OFFSET, REPLY_SENT_FRAME_COUNT_SIZE);
+    *echoUTime       = be64toh(beEchoUTime);
+    *receiveUTime    = be64toh(beReceiveUTime);
+    *sendUTime       = be64toh(beSendUTime);
+    *sentPacketCount = be64toh(beSentPacketCount);
+    *sentFrameCount  = be64toh(beSentFrameCount);
+}
+
+void VideoUDPSharedWriteDescriptor(void* descriptor, uint32_t maxPacketLength, uint32_t maxJPEGLength, uint32_t width, uint32_t height, uint32_t timebaseNumerator, uint32_t timebaseDenominator, uint32_t fecPercent, bool restart) {
+    uint16_t beMaxPacketLength     = htons(maxPacketLength);
+    uint32_t beMaxJPEGLength       = htonl(maxJPEGLength);
+    uint16_t beWidth               = htons(width);
+    uint16_t beHeight              = htons(height);
+    uint32_t beTimebaseNumerator   = htonl(timebaseNumerator);
+    uint32_t beTimebaseDenominator = htonl(timebaseDenominator);
+    uint8_t  fecPercentByte        = fecPercent;
+    uint8_t  flags                 = restart ? DESCRIPTOR_FLAG_RESTART : 0;
+    memcpy(descriptor + DESCRIPTOR_MAX_PACKET_LENGTH_OFFSET, &beMaxPacketLength, DESCRIPTOR_MAX_PACKET_LENGTH_SIZE);
+    memcpy(descriptor + DESCRIPTOR_MAX_JPEG_LENGTH_OFFSET, &beMaxJPEGLength, DESCRIPTOR_MAX_JPEG_LENGTH_SIZE);
+    memcpy(descriptor + DESCRIPTOR_WIDTH_OFFSET, &beWidth, DESCRIPTOR_WIDTH_SIZE);
+    memcpy(descriptor + DESCRIPTOR_HEIGHT_OFFSET, &beHeight, DESCRIPTOR_HEIGHT_SIZE);
+    memcpy(descriptor + DESCRIPTOR_TIMEBASE_NUMERATOR_OFFSET, &beTimebaseNumerator, DESCRIPTOR_TIMEBASE_NUMERATOR_SIZE);
+    memcpy(descriptor + DESCRIPTOR_TIMEBASE_DENOMINATOR_OFFSET, &beTimebaseDenominator, DESCRIPTOR_TIMEBASE_DENOMINATOR_SIZE);
+    memcpy(descriptor + DESCRIPTOR_FEC_PERCENT_OFFSET, &fecPercentByte, DESCRIPTOR_FEC_PERCENT_SIZE);
+    memcpy(descriptor + DESCRIPTOR_FLAGS_OFFSET, &flags, DESCRIPTOR_FLAGS_SIZE);
+}
+
+void VideoUDPSharedReadDescriptor(const void* descriptor, uint32_t* maxPacketLength, uint32_t* maxJPEGLength, uint32_t* width, uint32_t* height, uint32_t* timebaseNumerator, uint32_t* timebaseDenominator, uint32_t* fecPercent, bool* restart) {
+    uint16_t beMaxPacketLength;
+    uint32_t beMaxJPEGLength;
+    uint16_t beWidth;
+    uint16_t beHeight;
+    uint32_t beTimebaseNumerator;
+    uint32_t beTimebaseDenominator;
+    uint8_t  fecPercentByte;
+    uint8_t  flags;
+    memcpy(&beMaxPacketLength, descriptor + DESCRIPTOR_MAX_PACKET_LENGTH_OFFSET, DESCRIPTOR_MAX_PACKET_LENGTH_SIZE);
+    memcpy(&beMaxJPEGLength, descriptor + DESCRIPTOR_MAX_JPEG_LENGTH_OFFSET, DESCRIPTOR_MAX_JPEG_LENGTH_SIZE);
+    memcpy(&beWidth, descriptor + DESCRIPTOR_WIDTH_OFFSET, DESCRIPTOR_WIDTH_SIZE);
+    memcpy(&beHeight, descriptor + DESCRIPTOR_HEIGHT_OFFSET, DESCRIPTOR_HEIGHT_SIZE);
+    memcpy(&beTimebaseNumerator, descriptor + DESCRIPTOR_TIMEBASE_NUMERATOR_OFFSET, DESCRIPTOR_TIMEBASE_NUMERATOR_SIZE);
+    memcpy(&beTimebaseDenominator, descriptor + DESCRIPTOR_TIMEBASE_DENOMINATOR_OFFSET, DESCRIPTOR_TIMEBASE_DENOMINATOR_SIZE);
+    memcpy(&fecPercentByte, descriptor + DESCRIPTOR_FEC_PERCENT_OFFSET, DESCRIPTOR_FEC_PERCENT_SIZE);
+    memcpy(&flags, descriptor + DESCRIPTOR_FLAGS_OFFSET, DESCRIPTOR_FLAGS_SIZE);
+    *maxPacketLength     = ntohs(beMaxPacketLength);
+    *maxJPEGLength       = ntohl(beMaxJPEGLength);
+    *width               = ntohs(beWidth);
+    *height              = ntohs(beHeight);
+    *timebaseNumerator   = ntohl(beTimebaseNumerator);
+    *timebaseDenominator = ntohl(beTimebaseDenominator);
+    *fecPercent          = fecPercentByte;
+    *restart             = (flags & DESCRIPTOR_FLAG_RESTART) != 0;
+}
+
+uint64_t VideoUDPSharedGetEpochUSeconds() {
+    struct timeval epochTime;
+    gettimeofday(&epochTime, NULL);
+    return (uint64_t)epochTime.tv_sec * 1000000 + epochTime.tv_usec;
+}
+
+uint32_t VideoUDPSharedFindRestartMarkerEnd(const uint8_t* data, uint32_t start, uint32_t end) {
+    while (start + 1 < end) {
+        const uint8_t* markerStart = memchr(data + start, 0xFF, end - start - 1);
+        if (markerStart == NULL) {
+            return 0;
+        }
+        start              = markerStart - data + 1;
+        uint8_t markerCode = data[start];
+        if ((markerCode >= 0xD0 && markerCode <= 0xD7) || markerCode == 0xD9) {
+            return start + 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t VideoUDPSharedGetMaxPacketCount(unsigned int maxJPEGLength, unsigned int maxPacketBodyLength, bool restart) {
+    if (!restart) {
+        return (maxJPEGLength / maxPacketBodyLength) + 1;
+    }
+    return 2 * (maxJPEGLength / (maxPacketBodyLength - RESTART_PREFIX_LENGTH)) + 3;
+}
+
+uint32_t VideoUDPSharedGetParityPacketCount(uint32_t packetCount, unsigned int fecPercent) {
+    if (fecPercent == 0 || packetCount == 0) {
+        return 0;
+    }
+    uint32_t parityPacketCount = ((uint64_t)packetCount * fecPercent + MAX_FEC_PERCENT - 1) / MAX_FEC_PERCENT;
+    return parityPacketCount < packetCount ? parityPacketCount : packetCount;
+}
+
+void VideoUDPSharedXOR(void* destination, const void* source, size_t length) {
+    uint8_t*       destinationBytes = destination;
+    const uint8_t* sourceBytes      = source;
+    size_t         byteIndex        = 0;
+    for (; byteIndex + sizeof(uint64_t) <= length; byteIndex += sizeof(uint64_t)) {
+        uint64_t destinationWord;
+        uint64_t sourceWord;
+        memcpy(&destinationWord, destinationBytes + byteIndex, sizeof(uint64_t));
+        memcpy(&sourceWord, sourceBytes + byteIndex, sizeof(uint64_t));
+        destinationWord ^= sourceWord;
+        memcpy(destinationBytes + byteIndex, &destinationWord, sizeof(uint64_t));
+    }
+    for (; byteIndex < length; byteIndex++) {
+        destinationBytes[byteIndex] ^= sourceBytes[byteIndex];
+    }
 }
\ No newline at end of file